@@ -30,9 +30,64 @@
   
 /* Includes ---------------------------------------------------------------------*/
 #include "74165_platform.h"
+#include <stddef.h>
 #include <avr/io.h>
+#if (IC74165_SPI_USE_ISR)
+#include <avr/interrupt.h>
+#endif
 #define F_CPU IC74165_AVR_CLK
 #include <util/delay.h>
+#include <util/delay_basic.h>
+
+
+/* Private Macros ---------------------------------------------------------------*/
+/**
+ * @brief  Duration of one CPU cycle (ns)
+ */
+#define IC74165_CYCLE_NS        (1000000000UL / IC74165_AVR_CLK)
+
+/**
+ * @brief  SPI clock rate bits (SPR1:0 in SPCR and SPI2X in SPSR)
+ */
+#if (IC74165_SPI_CLOCK_DIV == 2)
+#define IC74165_SPI_SPR   0
+#define IC74165_SPI_2X    1
+#elif (IC74165_SPI_CLOCK_DIV == 4)
+#define IC74165_SPI_SPR   0
+#define IC74165_SPI_2X    0
+#elif (IC74165_SPI_CLOCK_DIV == 8)
+#define IC74165_SPI_SPR   1
+#define IC74165_SPI_2X    1
+#elif (IC74165_SPI_CLOCK_DIV == 16)
+#define IC74165_SPI_SPR   1
+#define IC74165_SPI_2X    0
+#elif (IC74165_SPI_CLOCK_DIV == 32)
+#define IC74165_SPI_SPR   2
+#define IC74165_SPI_2X    1
+#elif (IC74165_SPI_CLOCK_DIV == 64)
+#define IC74165_SPI_SPR   2
+#define IC74165_SPI_2X    0
+#elif (IC74165_SPI_CLOCK_DIV == 128)
+#define IC74165_SPI_SPR   3
+#define IC74165_SPI_2X    0
+#else
+#error "IC74165_SPI_CLOCK_DIV must be 2, 4, 8, 16, 32, 64 or 128"
+#endif
+
+
+/* Private Variables ------------------------------------------------------------*/
+// Handler of the GPIO mode and its CLK phases in _delay_loop_1 counts, set at
+// init
+static IC74165_Handler_t *IC74165_Handler = NULL;
+static uint8_t IC74165_ClkHighLoops = 0;
+static uint8_t IC74165_ClkLowLoops = 0;
+
+#if (IC74165_SPI_USE_ISR)
+// Transfer started by IC74165_SPI_StartTransfer, advanced by the ISR
+static uint8_t *volatile IC74165_SPI_SendData = NULL;
+static uint8_t *volatile IC74165_SPI_ReceiveData = NULL;
+static volatile uint16_t IC74165_SPI_Remaining = 0;
+#endif
 
 
 
@@ -111,6 +166,183 @@ IC74165_DelayUs(uint8_t Delay)
     _delay_us(1);
 }
 
+/**
+ * @brief  _delay_loop_1 counts (3 cycles each) of a delay, rounded up
+ */
+static uint32_t
+IC74165_NsToLoops(uint16_t Ns)
+{
+  return ((uint32_t)Ns + 3 * IC74165_CYCLE_NS - 1) / (3 * IC74165_CYCLE_NS);
+}
+
+static void
+IC74165_DelayNs(uint16_t Delay)
+{
+  uint32_t Count = IC74165_NsToLoops(Delay);
+
+  for (; Count > 255; Count -= 255)
+    _delay_loop_1(0);
+  if (Count)
+    _delay_loop_1((uint8_t)Count);
+}
+
+static void
+IC74165_PlatformInit_Delay(void)
+{
+  uint32_t Loops;
+
+  IC74165_PlatformInit();
+
+  // Delay is resolved by the core before Init, net of the edge latency;
+  // ClkLow already covers Setup. Longer phases are limited to 255 loops
+  // (about 96 us at 8 MHz).
+  Loops = IC74165_NsToLoops(IC74165_Handler->Delay.ClkHigh);
+  IC74165_ClkHighLoops = (Loops > 255) ? 255 : (uint8_t)Loops;
+  Loops = IC74165_NsToLoops(IC74165_Handler->Delay.ClkLow);
+  IC74165_ClkLowLoops = (Loops > 255) ? 255 : (uint8_t)Loops;
+}
+
+static void
+IC74165_ShiftBytes(uint8_t *Data, uint8_t Count)
+{
+  uint8_t HighLoops = IC74165_ClkHighLoops;
+  uint8_t LowLoops = IC74165_ClkLowLoops;
+
+  for (; Count; --Count)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      Buffer <<= 1;
+      if (IC74165_QH_PIN & (1 << IC74165_QH_NUM))
+        Buffer |= 1;
+      IC74165_CLK_PORT |= (1<<IC74165_CLK_NUM);
+      if (HighLoops)
+        _delay_loop_1(HighLoops);
+      IC74165_CLK_PORT &= ~(1<<IC74165_CLK_NUM);
+      if (LowLoops)
+        _delay_loop_1(LowLoops);
+    }
+
+    if (Data != NULL)
+      *Data++ = Buffer;
+  }
+}
+
+static void
+IC74165_PlatformInit_SPI(void)
+{
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_CLKINH_DDR |= (1<<IC74165_CLKINH_NUM);
+  IC74165_CLKINH_PORT |= (1<<IC74165_CLKINH_NUM);
+#endif
+  // MOSI (PB5), SCK (PB7) and SS (PB4) as output, MISO (PB6) as input
+  DDRB |= (1<<PB5) | (1<<PB7) | (1<<PB4);
+  DDRB &= ~(1<<PB6);
+  PORTB |= (1<<PB5);
+
+  // Master, mode 1 (CPOL = 0, CPHA = 1), MSB first
+  SPCR = (1<<SPE) | (1<<MSTR) | (1<<CPHA) | IC74165_SPI_SPR;
+  SPSR = (IC74165_SPI_2X << SPI2X);
+}
+
+static void
+IC74165_PlatformDeInit_SPI(void)
+{
+  SPCR = 0;
+#if (IC74165_SPI_USE_ISR)
+  IC74165_SPI_Remaining = 0;
+#endif
+  DDRB &= ~((1<<PB5) | (1<<PB7) | (1<<PB4));
+  PORTB &= ~(1<<PB5);
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_CLKINH_DDR &= ~(1<<IC74165_CLKINH_NUM);
+  IC74165_CLKINH_PORT &= ~(1<<IC74165_CLKINH_NUM);
+#endif
+}
+
+static void
+IC74165_SPI_SendReceive(uint8_t *SendData,
+                        uint8_t *ReceiveData,
+                        uint8_t Len)
+{
+  for (; Len; --Len)
+  {
+    SPDR = SendData ? *SendData++ : 0xFF;
+    while (!(SPSR & (1<<SPIF)))
+    {
+    }
+
+    if (ReceiveData)
+      *ReceiveData++ = SPDR;
+  }
+}
+
+#if (IC74165_SPI_USE_ISR)
+ISR(SPI_STC_vect)
+{
+  uint8_t Received = SPDR;
+  uint8_t *ReceiveData = IC74165_SPI_ReceiveData;
+  uint8_t *SendData = IC74165_SPI_SendData;
+
+  if (ReceiveData)
+  {
+    *ReceiveData++ = Received;
+    IC74165_SPI_ReceiveData = ReceiveData;
+  }
+
+  if (--IC74165_SPI_Remaining)
+  {
+    if (SendData)
+    {
+      SPDR = *SendData++;
+      IC74165_SPI_SendData = SendData;
+    }
+    else
+    {
+      SPDR = 0xFF;
+    }
+  }
+  else
+  {
+    SPCR &= ~(1<<SPIE);
+  }
+}
+
+static uint8_t
+IC74165_SPI_StartTransfer(uint8_t *SendData,
+                          uint8_t *ReceiveData,
+                          size_t Len)
+{
+  if (IC74165_SPI_Remaining || Len == 0 || Len > 0xFFFF)
+    return 0;
+
+  IC74165_SPI_SendData = SendData;
+  IC74165_SPI_ReceiveData = ReceiveData;
+  IC74165_SPI_Remaining = (uint16_t)Len;
+
+  // The first byte is written here, the ISR writes the rest
+  if (SendData)
+  {
+    SPDR = *SendData++;
+    IC74165_SPI_SendData = SendData;
+  }
+  else
+  {
+    SPDR = 0xFF;
+  }
+  SPCR |= (1<<SPIE);
+
+  return 1;
+}
+
+static uint8_t
+IC74165_SPI_IsComplete(void)
+{
+  return IC74165_SPI_Remaining ? 0 : 1;
+}
+#endif
+
 
 
 /**
@@ -129,7 +361,7 @@ void
 IC74165_Platform_Init(IC74165_Handler_t *Handler)
 {
   IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_GPIO);
-  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit_Delay);
   IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit);
 #if (IC74165_CLKINH_ENABLE)
   IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
@@ -138,4 +370,31 @@ IC74165_Platform_Init(IC74165_Handler_t *Handler)
   IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(Handler, IC74165_ShLdWrite);
   IC74165_PLATFORM_LINK_GPIO_QHREAD(Handler, IC74165_QhRead);
   IC74165_PLATFORM_LINK_GPIO_DELAYUS(Handler, IC74165_DelayUs);
+  IC74165_PLATFORM_LINK_GPIO_DELAYNS(Handler, IC74165_DelayNs);
+  IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(Handler, IC74165_ShiftBytes);
+  // A pin write takes at least two CPU cycles (sbi/cbi)
+  IC74165_PLATFORM_SET_GPIO_EDGELATENCY(Handler, 2 * IC74165_CYCLE_NS);
+  IC74165_Handler = Handler;
+}
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         SPI peripheral.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler)
+{
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_SPI);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit_SPI);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit_SPI);
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_SPI_SENDRECEIVE(Handler, IC74165_SPI_SendReceive);
+#if (IC74165_SPI_USE_ISR)
+  IC74165_PLATFORM_LINK_SPI_STARTTRANSFER(Handler, IC74165_SPI_StartTransfer);
+  IC74165_PLATFORM_LINK_SPI_ISCOMPLETE(Handler, IC74165_SPI_IsComplete);
+#endif
 }
@@ -62,6 +62,20 @@ extern "C" {
 #define IC74165_CLKINH_NUM    3
 #define IC74165_CLKINH_ENABLE 0
 
+/**
+ * @brief  SPI options
+ *         - IC74165_SPI_CLOCK_DIV: SPI clock = IC74165_AVR_CLK / DIV
+ *           (2, 4, 8, 16, 32, 64 or 128)
+ *         - IC74165_SPI_USE_ISR: 1 to shift the bytes of IC74165_ReadAllAsync
+ *           from the SPI serial transfer complete interrupt, so the CPU is
+ *           free between bytes. Global interrupts must be enabled (sei).
+ *           Blocking reads still poll SPIF.
+ * @note   In SPI mode the MOSI (PB5), MISO (PB6) and SCK (PB7) pins must be
+ *         connected to SH/LD, Qh and CLK pins of 74165. SS (PB4) is driven as
+ *         output.
+ */
+#define IC74165_SPI_CLOCK_DIV 2
+#define IC74165_SPI_USE_ISR   0
 
 
 /**
@@ -80,6 +94,16 @@ void
 IC74165_Platform_Init(IC74165_Handler_t *Handler);
 
 
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         SPI peripheral.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler);
+
+
 
 #ifdef __cplusplus
 }
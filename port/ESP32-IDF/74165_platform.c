@@ -31,14 +31,56 @@
 /* Includes ---------------------------------------------------------------------*/
 #include "74165_platform.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
 #include "rom/ets_sys.h"
+#include <string.h>
 
 
 /* Private Variables ------------------------------------------------------------*/
 static spi_device_handle_t spi_device_handle = {0};
 
+// DMA capable buffers and transaction descriptor, built once at init
+static spi_transaction_t IC74165_SPI_Trans = {0};
+static uint8_t *IC74165_SPI_TxBuff = NULL;
+static uint8_t *IC74165_SPI_RxBuff = NULL;
+// Descriptor and destination of the transfer started by StartTransfer. The
+// queued descriptor belongs to the driver until its result is taken.
+static spi_transaction_t IC74165_SPI_AsyncTrans = {0};
+static uint8_t *IC74165_SPI_AsyncData = NULL;
+static size_t IC74165_SPI_AsyncLen = 0;
+static uint8_t IC74165_SPI_AsyncPending = 0;
+#if (IC74165_SPI_ACQUIRE_BUS)
+// Serializes scans of this port, so a try-scan can fail without waiting. It is
+// binary, not a mutex: an asynchronous scan or a continuous run may end in
+// another task than the one that started it.
+static SemaphoreHandle_t IC74165_SPI_Lock = NULL;
+#endif
+
+// Handler of the fast mode and its CLK phases in CPU cycles, set at init
+static IC74165_Handler_t *IC74165_FastHandler = NULL;
+static uint32_t IC74165_FastClkHighCycles = 0;
+static uint32_t IC74165_FastClkLowCycles = 0;
+
+static struct
+{
+  spi_transaction_t Load[IC74165_SPI_QUEUE_LEN];
+  spi_transaction_t Shift[IC74165_SPI_QUEUE_LEN];
+  uint8_t *RxBuff[IC74165_SPI_QUEUE_LEN];
+  uint16_t Len;
+  uint8_t Running;
+  uint8_t InFlight;
+  IC74165_Platform_FrameCallback_t Callback;
+  void *Ctx;
+} IC74165_Continuous = {0};
+
 
 
 /**
@@ -115,6 +157,114 @@ IC74165_DelayUs(uint8_t Delay)
   ets_delay_us(Delay);
 }
 
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+static uint32_t
+IC74165_GetTick(void)
+{
+  // Microseconds; the same on both cores, unlike the CPU cycle counter
+  return (uint32_t)esp_timer_get_time();
+}
+#endif
+
+static void
+IC74165_ShiftBytes(uint8_t *Data, uint8_t Count)
+{
+  for (; Count; --Count)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      Buffer |= (gpio_get_level(IC74165_QH_GPIO) << j);
+      gpio_set_level(IC74165_CLK_GPIO, 1);
+      ets_delay_us(1);
+      gpio_set_level(IC74165_CLK_GPIO, 0);
+      ets_delay_us(1);
+    }
+
+    if (Data != NULL)
+      *Data++ = Buffer;
+  }
+}
+
+static inline void
+IC74165_FastWait(uint32_t Cycles)
+{
+  uint32_t Start = esp_cpu_get_cycle_count();
+  while ((uint32_t)(esp_cpu_get_cycle_count() - Start) < Cycles)
+  {
+  }
+}
+
+#if (IC74165_CLKINH_ENABLE)
+static void
+IC74165_FastClkInhWrite(uint8_t Level)
+{
+  gpio_ll_set_level(&GPIO, IC74165_CLKINH_GPIO, Level);
+}
+#endif
+
+static uint8_t
+IC74165_FastQhRead(void)
+{
+  return gpio_ll_get_level(&GPIO, IC74165_QH_GPIO);
+}
+
+static void
+IC74165_FastClkWrite(uint8_t Level)
+{
+  gpio_ll_set_level(&GPIO, IC74165_CLK_GPIO, Level);
+}
+
+static void
+IC74165_FastShLdWrite(uint8_t Level)
+{
+  gpio_ll_set_level(&GPIO, IC74165_SHLD_GPIO, Level);
+}
+
+static inline uint32_t
+IC74165_FastNsToCycles(uint16_t Ns)
+{
+  return ((uint32_t)Ns * esp_rom_get_cpu_ticks_per_us() + 999) / 1000;
+}
+
+static void
+IC74165_FastPlatformInit(void)
+{
+  IC74165_PlatformInit();
+
+  // Delay is resolved by the core before Init; ClkLow already covers Setup
+  IC74165_FastClkHighCycles =
+      IC74165_FastNsToCycles(IC74165_FastHandler->Delay.ClkHigh);
+  IC74165_FastClkLowCycles =
+      IC74165_FastNsToCycles(IC74165_FastHandler->Delay.ClkLow);
+}
+
+static void
+IC74165_FastDelayNs(uint16_t Delay)
+{
+  IC74165_FastWait(IC74165_FastNsToCycles(Delay));
+}
+
+static void
+IC74165_FastShiftBytes(uint8_t *Data, uint8_t Count)
+{
+  for (; Count; --Count)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      Buffer |= (gpio_ll_get_level(&GPIO, IC74165_QH_GPIO) << j);
+      gpio_ll_set_level(&GPIO, IC74165_CLK_GPIO, 1);
+      IC74165_FastWait(IC74165_FastClkHighCycles);
+      gpio_ll_set_level(&GPIO, IC74165_CLK_GPIO, 0);
+      IC74165_FastWait(IC74165_FastClkLowCycles);
+    }
+
+    if (Data != NULL)
+      *Data++ = Buffer;
+  }
+}
+
 static void
 IC74165_PlatformInit_SPI(void)
 {
@@ -125,11 +275,11 @@ IC74165_PlatformInit_SPI(void)
     .sclk_io_num = IC74165_CLK_GPIO,
     .quadwp_io_num = -1,
     .quadhd_io_num = -1,
-    .max_transfer_sz = 10,
+    .max_transfer_sz = IC74165_SPI_MAX_CHAIN_LEN + 1,
     .flags = 0,
     .intr_flags = 0
   };
-  spi_bus_initialize(IC74165_SPI_NUM, &spi_bus_config, 0);
+  spi_bus_initialize(IC74165_SPI_NUM, &spi_bus_config, SPI_DMA_CH_AUTO);
 
   const spi_device_interface_config_t spi_device_interface_config =
   {
@@ -144,12 +294,31 @@ IC74165_PlatformInit_SPI(void)
     .input_delay_ns = 0,
     .spics_io_num = -1,
     .flags = 0,
-    .queue_size = 1,
+    .queue_size = 2 * IC74165_SPI_QUEUE_LEN,
     .pre_cb = (void *)0,
     .post_cb = (void *)0
   };
   spi_bus_add_device(IC74165_SPI_NUM, &spi_device_interface_config, &spi_device_handle);
 
+  // DMA receive length must be a multiple of 4 bytes
+  IC74165_SPI_TxBuff = heap_caps_malloc((IC74165_SPI_MAX_CHAIN_LEN + 3) & ~3,
+                                        MALLOC_CAP_DMA);
+  IC74165_SPI_RxBuff = heap_caps_malloc((IC74165_SPI_MAX_CHAIN_LEN + 3) & ~3,
+                                        MALLOC_CAP_DMA);
+  if (IC74165_SPI_TxBuff)
+    memset(IC74165_SPI_TxBuff, 0xFF, IC74165_SPI_MAX_CHAIN_LEN);
+
+  memset(&IC74165_SPI_Trans, 0, sizeof(spi_transaction_t));
+  IC74165_SPI_Trans.flags = 0;
+  IC74165_SPI_Trans.rxlength = 0;
+  memset(&IC74165_SPI_AsyncTrans, 0, sizeof(spi_transaction_t));
+
+#if (IC74165_SPI_ACQUIRE_BUS)
+  IC74165_SPI_Lock = xSemaphoreCreateBinary();
+  if (IC74165_SPI_Lock)
+    xSemaphoreGive(IC74165_SPI_Lock);
+#endif
+
 #if (IC74165_CLKINH_ENABLE)
   IC74165_SetGPIO_OUT(IC74165_CLKINH_GPIO);
 #endif
@@ -163,48 +332,144 @@ IC74165_PlatformDeInit_SPI(void)
 #endif
   spi_bus_remove_device(spi_device_handle);
   spi_bus_free(IC74165_SPI_NUM);
+
+  heap_caps_free(IC74165_SPI_TxBuff);
+  heap_caps_free(IC74165_SPI_RxBuff);
+  IC74165_SPI_TxBuff = NULL;
+  IC74165_SPI_RxBuff = NULL;
+
+#if (IC74165_SPI_ACQUIRE_BUS)
+  if (IC74165_SPI_Lock)
+    vSemaphoreDelete(IC74165_SPI_Lock);
+  IC74165_SPI_Lock = NULL;
+#endif
+}
+
+#if (IC74165_SPI_ACQUIRE_BUS)
+static uint8_t
+IC74165_SPI_BusAcquire(uint8_t Block)
+{
+  if (IC74165_SPI_Lock == NULL ||
+      xSemaphoreTake(IC74165_SPI_Lock, Block ? portMAX_DELAY : 0) != pdTRUE)
+    return 0;
+
+  // spi_device_acquire_bus only accepts portMAX_DELAY, so a try-scan still
+  // waits here if another device holds the bus
+  if (spi_device_acquire_bus(spi_device_handle, portMAX_DELAY) != ESP_OK)
+  {
+    xSemaphoreGive(IC74165_SPI_Lock);
+    return 0;
+  }
+
+  return 1;
 }
 
+static void
+IC74165_SPI_BusRelease(void)
+{
+  spi_device_release_bus(spi_device_handle);
+  xSemaphoreGive(IC74165_SPI_Lock);
+}
+#endif
+
 static void
 IC74165_SPI_SendReceive(uint8_t *SendData,
                         uint8_t *ReceiveData,
-                        uint8_t Len)
+                        size_t Len)
 {
-  spi_transaction_t spi_transaction = {0};
-  uint8_t TxBuff[SOC_SPI_MAXIMUM_BUFFER_SIZE] = {0xFF};
+  size_t Chunk;
 
-  spi_transaction.flags = 0;
-  spi_transaction.length = SOC_SPI_MAXIMUM_BUFFER_SIZE * 8;
-  spi_transaction.rxlength = 0;
+  if (IC74165_SPI_TxBuff == NULL || IC74165_SPI_RxBuff == NULL)
+    return;
 
-  while (Len > SOC_SPI_MAXIMUM_BUFFER_SIZE)
+  while (Len)
   {
-    spi_transaction.tx_buffer = SendData ? SendData : TxBuff;
-    spi_transaction.rx_buffer = ReceiveData;
-    if (spi_device_polling_transmit(spi_device_handle, &spi_transaction) != ESP_OK)
+    Chunk = (Len > IC74165_SPI_MAX_CHAIN_LEN) ? IC74165_SPI_MAX_CHAIN_LEN : Len;
+
+    IC74165_SPI_Trans.length = Chunk * 8;
+    IC74165_SPI_Trans.tx_buffer = SendData ? SendData : IC74165_SPI_TxBuff;
+    IC74165_SPI_Trans.rx_buffer = ReceiveData ? IC74165_SPI_RxBuff : NULL;
+    if (spi_device_polling_transmit(spi_device_handle, &IC74165_SPI_Trans) != ESP_OK)
       return;
 
-    Len -= SOC_SPI_MAXIMUM_BUFFER_SIZE;
     if (ReceiveData)
-      ReceiveData += SOC_SPI_MAXIMUM_BUFFER_SIZE;
+    {
+      memcpy(ReceiveData, IC74165_SPI_RxBuff, Chunk);
+      ReceiveData += Chunk;
+    }
     if (SendData)
-      SendData += SOC_SPI_MAXIMUM_BUFFER_SIZE;
+      SendData += Chunk;
+    Len -= Chunk;
   }
+}
+
+static uint8_t
+IC74165_SPI_StartTransfer(uint8_t *SendData,
+                          uint8_t *ReceiveData,
+                          size_t Len)
+{
+  if (IC74165_SPI_TxBuff == NULL || IC74165_SPI_RxBuff == NULL ||
+      IC74165_SPI_AsyncPending || Len == 0 || Len > IC74165_SPI_MAX_CHAIN_LEN)
+    return 0;
+
+  IC74165_SPI_AsyncTrans.length = Len * 8;
+  IC74165_SPI_AsyncTrans.tx_buffer = SendData ? SendData : IC74165_SPI_TxBuff;
+  IC74165_SPI_AsyncTrans.rx_buffer = ReceiveData ? IC74165_SPI_RxBuff : NULL;
+  if (spi_device_queue_trans(spi_device_handle, &IC74165_SPI_AsyncTrans, 0) != ESP_OK)
+    return 0;
 
-  if (Len)
+  IC74165_SPI_AsyncData = ReceiveData;
+  IC74165_SPI_AsyncLen = Len;
+  IC74165_SPI_AsyncPending = 1;
+  return 1;
+}
+
+static uint8_t
+IC74165_SPI_IsComplete(void)
+{
+  spi_transaction_t *Trans;
+
+  if (!IC74165_SPI_AsyncPending)
+    return 1;
+
+  if (spi_device_get_trans_result(spi_device_handle, &Trans, 0) != ESP_OK)
+    return 0;
+
+  if (IC74165_SPI_AsyncData)
+    memcpy(IC74165_SPI_AsyncData, IC74165_SPI_RxBuff, IC74165_SPI_AsyncLen);
+  IC74165_SPI_AsyncPending = 0;
+  return 1;
+}
+
+static void
+IC74165_ContinuousFree(void)
+{
+  for (uint8_t i = 0; i < IC74165_SPI_QUEUE_LEN; i++)
   {
-    spi_transaction.length = Len * 8;
-    spi_transaction.rxlength = 0;
-    spi_transaction.tx_buffer = SendData ? SendData : TxBuff;
-    spi_transaction.rx_buffer = ReceiveData;
-    if (spi_device_polling_transmit(spi_device_handle, &spi_transaction) != ESP_OK)
-      return;
+    heap_caps_free(IC74165_Continuous.RxBuff[i]);
+    IC74165_Continuous.RxBuff[i] = NULL;
   }
-
-  return;
 }
 
+static esp_err_t
+IC74165_ContinuousQueue(uint8_t Frame)
+{
+  esp_err_t Err;
+
+  Err = spi_device_queue_trans(spi_device_handle,
+                               &IC74165_Continuous.Load[Frame], 0);
+  if (Err != ESP_OK)
+    return Err;
+  IC74165_Continuous.InFlight++;
+
+  Err = spi_device_queue_trans(spi_device_handle,
+                               &IC74165_Continuous.Shift[Frame], 0);
+  if (Err != ESP_OK)
+    return Err;
+  IC74165_Continuous.InFlight++;
 
+  return ESP_OK;
+}
 
 
 
@@ -233,6 +498,41 @@ IC74165_Platform_Init(IC74165_Handler_t *Handler)
   IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(Handler, IC74165_ShLdWrite);
   IC74165_PLATFORM_LINK_GPIO_QHREAD(Handler, IC74165_QhRead);
   IC74165_PLATFORM_LINK_GPIO_DELAYUS(Handler, IC74165_DelayUs);
+  IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(Handler, IC74165_ShiftBytes);
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+  IC74165_PLATFORM_LINK_GETTICK(Handler, IC74165_GetTick);
+#endif
+}
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         GPIO registers directly.
+ * @note   Pins are driven through the W1TS/W1TC and IN registers instead of
+ *         the GPIO driver, and the whole byte-shift loop runs inside the port.
+ *         The loop waits the CLK phases of the handler's timing profile, so
+ *         only one handler at a time can use this mode.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_Fast(IC74165_Handler_t *Handler)
+{
+  IC74165_FastHandler = Handler;
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_GPIO);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_FastPlatformInit);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit);
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_FastClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_GPIO_CLKWRITE(Handler, IC74165_FastClkWrite);
+  IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(Handler, IC74165_FastShLdWrite);
+  IC74165_PLATFORM_LINK_GPIO_QHREAD(Handler, IC74165_FastQhRead);
+  IC74165_PLATFORM_LINK_GPIO_DELAYNS(Handler, IC74165_FastDelayNs);
+  IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(Handler, IC74165_FastShiftBytes);
+  IC74165_PLATFORM_SET_GPIO_EDGELATENCY(Handler, IC74165_FAST_EDGE_LATENCY);
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+  IC74165_PLATFORM_LINK_GETTICK(Handler, IC74165_GetTick);
+#endif
 }
 
 /**
@@ -250,6 +550,163 @@ IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler)
 #if (IC74165_CLKINH_ENABLE)
   IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
 #endif
-  IC74165_PLATFORM_LINK_SPI_SENDRECEIVE(Handler, IC74165_SPI_SendReceive);
+  IC74165_PLATFORM_LINK_SPI_SENDRECEIVEWIDE(Handler, IC74165_SPI_SendReceive);
+  IC74165_PLATFORM_LINK_SPI_STARTTRANSFER(Handler, IC74165_SPI_StartTransfer);
+  IC74165_PLATFORM_LINK_SPI_ISCOMPLETE(Handler, IC74165_SPI_IsComplete);
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+  IC74165_PLATFORM_LINK_GETTICK(Handler, IC74165_GetTick);
+#endif
+#if (IC74165_SPI_ACQUIRE_BUS)
+  IC74165_PLATFORM_LINK_BUSACQUIRE(Handler, IC74165_SPI_BusAcquire);
+  IC74165_PLATFORM_LINK_BUSRELEASE(Handler, IC74165_SPI_BusRelease);
+#endif
 }
 
+/**
+ * @brief  Start SPI continuous acquisition mode.
+ * @note   IC74165_SPI_QUEUE_LEN pre-built frames (load + shift) are queued on
+ *         the SPI DMA and requeued as soon as they are handed to the
+ *         application. The handler must not be used by other functions of the
+ *         library until IC74165_Platform_SPI_ContinuousStop is called.
+ * @note   With IC74165_SPI_ACQUIRE_BUS, the SPI bus is held from start to stop
+ *         and TryReadAll returns IC74165_BUSY in between.
+ * @param  Handler: Pointer to handler initialized with IC74165_Platform_Init_SPI
+ *                  and IC74165_Init
+ * @param  Callback: Function to call for each completed frame
+ * @param  Ctx: User context
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Platform_SPI_ContinuousStart(IC74165_Handler_t *Handler,
+                                     IC74165_Platform_FrameCallback_t Callback,
+                                     void *Ctx)
+{
+  uint16_t Len = Handler->ChainLen;
+  // DMA receive length must be a multiple of 4 bytes
+  size_t Size = (Len + 3) & ~3;
+
+  if (IC74165_Continuous.Running || Callback == NULL || IC74165_SPI_TxBuff == NULL ||
+      Len == 0 || Len > IC74165_SPI_MAX_CHAIN_LEN)
+    return IC74165_FAIL;
+
+  for (uint8_t i = 0; i < IC74165_SPI_QUEUE_LEN; i++)
+  {
+    IC74165_Continuous.RxBuff[i] = heap_caps_malloc(Size, MALLOC_CAP_DMA);
+    if (IC74165_Continuous.RxBuff[i] == NULL)
+    {
+      IC74165_ContinuousFree();
+      return IC74165_FAIL;
+    }
+
+    // SH/LD low for one byte: parallel load
+    memset(&IC74165_Continuous.Load[i], 0, sizeof(spi_transaction_t));
+    IC74165_Continuous.Load[i].flags = SPI_TRANS_USE_TXDATA;
+    IC74165_Continuous.Load[i].length = 8;
+    IC74165_Continuous.Load[i].tx_data[0] = 0x00;
+
+    // SH/LD high: shift the chain
+    memset(&IC74165_Continuous.Shift[i], 0, sizeof(spi_transaction_t));
+    IC74165_Continuous.Shift[i].length = Len * 8;
+    IC74165_Continuous.Shift[i].tx_buffer = IC74165_SPI_TxBuff;
+    IC74165_Continuous.Shift[i].rx_buffer = IC74165_Continuous.RxBuff[i];
+    IC74165_Continuous.Shift[i].user = (void *)(uintptr_t)i;
+  }
+
+  IC74165_Continuous.Len = Len;
+  IC74165_Continuous.InFlight = 0;
+  IC74165_Continuous.Callback = Callback;
+  IC74165_Continuous.Ctx = Ctx;
+
+#if (IC74165_SPI_ACQUIRE_BUS)
+  // Held until stop, so no other transfer comes between the frames
+  if (!IC74165_SPI_BusAcquire(1))
+  {
+    IC74165_ContinuousFree();
+    return IC74165_FAIL;
+  }
+#endif
+
+#if (IC74165_CLKINH_ENABLE)
+  gpio_set_level(IC74165_CLKINH_GPIO, 0);
+#endif
+
+  for (uint8_t i = 0; i < IC74165_SPI_QUEUE_LEN; i++)
+  {
+    if (IC74165_ContinuousQueue(i) != ESP_OK)
+    {
+      IC74165_Continuous.Running = 1;
+      IC74165_Platform_SPI_ContinuousStop();
+      return IC74165_FAIL;
+    }
+  }
+
+  IC74165_Continuous.Running = 1;
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Wait for the next completed frame, hand it to the callback and
+ *         requeue it.
+ * @param  TimeoutMs: Maximum time to wait for a frame (ms)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: A frame was handed to the callback.
+ *         - IC74165_FAIL: No frame completed in time or mode is not started.
+ */
+IC74165_Result_t
+IC74165_Platform_SPI_ContinuousProcess(uint32_t TimeoutMs)
+{
+  spi_transaction_t *Trans;
+  uint8_t Frame;
+
+  if (!IC74165_Continuous.Running)
+    return IC74165_FAIL;
+
+  // Results come back in queue order: load of a frame, then its shift
+  do
+  {
+    if (spi_device_get_trans_result(spi_device_handle, &Trans,
+                                    pdMS_TO_TICKS(TimeoutMs)) != ESP_OK)
+      return IC74165_FAIL;
+    IC74165_Continuous.InFlight--;
+  } while (Trans->rx_buffer == NULL);
+
+  Frame = (uint8_t)(uintptr_t)Trans->user;
+  IC74165_Continuous.Callback(IC74165_Continuous.RxBuff[Frame],
+                              IC74165_Continuous.Len, IC74165_Continuous.Ctx);
+
+  if (IC74165_ContinuousQueue(Frame) != ESP_OK)
+    return IC74165_FAIL;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Stop SPI continuous acquisition mode.
+ * @note   It waits for the frames on the wire to complete.
+ * @retval None
+ */
+void
+IC74165_Platform_SPI_ContinuousStop(void)
+{
+  spi_transaction_t *Trans;
+
+  if (!IC74165_Continuous.Running)
+    return;
+
+  for (; IC74165_Continuous.InFlight; IC74165_Continuous.InFlight--)
+    spi_device_get_trans_result(spi_device_handle, &Trans, portMAX_DELAY);
+
+#if (IC74165_CLKINH_ENABLE)
+  gpio_set_level(IC74165_CLKINH_GPIO, 1);
+#endif
+#if (IC74165_SPI_ACQUIRE_BUS)
+  IC74165_SPI_BusRelease();
+#endif
+
+  IC74165_ContinuousFree();
+  IC74165_Continuous.Running = 0;
+}
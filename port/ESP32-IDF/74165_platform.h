@@ -54,6 +54,48 @@ extern "C" {
 #define IC74165_SPI_NUM       HSPI_HOST
 #define IC74165_SPI_CLK       3000000
 
+/**
+ * @brief  Fast GPIO mode (IC74165_Platform_Init_Fast) options
+ *         - IC74165_FAST_EDGE_LATENCY: Latency of a GPIO register access (ns)
+ */
+#define IC74165_FAST_EDGE_LATENCY 25
+
+/**
+ * @brief  Maximum chain length in SPI mode (size of DMA buffers). A whole chain
+ *         up to this length is read in a single DMA transaction.
+ */
+#define IC74165_SPI_MAX_CHAIN_LEN 1024
+
+/**
+ * @brief  Number of frames queued at the same time in SPI continuous mode
+ */
+#define IC74165_SPI_QUEUE_LEN 2
+
+/**
+ * @brief  Acquire the SPI bus for a whole scan in SPI mode, so transfers of
+ *         other devices on IC74165_SPI_NUM can not come between load and shift.
+ *         Enable it if other devices share the bus.
+ * @note   IC74165_TryReadAll returns IC74165_BUSY without waiting if another
+ *         task scans through this port. ESP-IDF only accepts portMAX_DELAY in
+ *         spi_device_acquire_bus, so it still waits if another device holds
+ *         the bus.
+ */
+#define IC74165_SPI_ACQUIRE_BUS 0
+
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  Function type for SPI continuous mode frame.
+ * @param  Data: Pointer to ChainLen bytes of the completed frame
+ * @param  Len: Chain length
+ * @param  Ctx: User context
+ * @note   The next frame is already on the wire while this function runs.
+ */
+typedef void (*IC74165_Platform_FrameCallback_t)(const uint8_t *Data,
+                                                 uint16_t Len, void *Ctx);
+
 
 
 /**
@@ -72,6 +114,20 @@ void
 IC74165_Platform_Init(IC74165_Handler_t *Handler);
 
 
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         GPIO registers directly.
+ * @note   Pins are driven through the W1TS/W1TC and IN registers instead of
+ *         the GPIO driver, and the whole byte-shift loop runs inside the port.
+ *         The loop waits the CLK phases of the handler's timing profile, so
+ *         only one handler at a time can use this mode.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_Fast(IC74165_Handler_t *Handler);
+
+
 /**
  * @brief  Initialize platform dependent layer to communicate with 74165 using
  *         SPI.
@@ -82,6 +138,49 @@ void
 IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler);
 
 
+/**
+ * @brief  Start SPI continuous acquisition mode.
+ * @note   IC74165_SPI_QUEUE_LEN pre-built frames (load + shift) are queued on
+ *         the SPI DMA and requeued as soon as they are handed to the
+ *         application. The handler must not be used by other functions of the
+ *         library until IC74165_Platform_SPI_ContinuousStop is called.
+ * @note   With IC74165_SPI_ACQUIRE_BUS, the SPI bus is held from start to stop
+ *         and TryReadAll returns IC74165_BUSY in between.
+ * @param  Handler: Pointer to handler initialized with IC74165_Platform_Init_SPI
+ *                  and IC74165_Init
+ * @param  Callback: Function to call for each completed frame
+ * @param  Ctx: User context
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Platform_SPI_ContinuousStart(IC74165_Handler_t *Handler,
+                                     IC74165_Platform_FrameCallback_t Callback,
+                                     void *Ctx);
+
+
+/**
+ * @brief  Wait for the next completed frame, hand it to the callback and
+ *         requeue it.
+ * @param  TimeoutMs: Maximum time to wait for a frame (ms)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: A frame was handed to the callback.
+ *         - IC74165_FAIL: No frame completed in time or mode is not started.
+ */
+IC74165_Result_t
+IC74165_Platform_SPI_ContinuousProcess(uint32_t TimeoutMs);
+
+
+/**
+ * @brief  Stop SPI continuous acquisition mode.
+ * @note   It waits for the frames on the wire to complete.
+ * @retval None
+ */
+void
+IC74165_Platform_SPI_ContinuousStop(void);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,558 @@
+/**
+ **********************************************************************************
+ * @file   74165_platform.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Simulated platform dependent layer for 74165 Driver
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+  
+/* Includes ---------------------------------------------------------------------*/
+#include "74165_platform.h"
+#include <stddef.h>
+#include <string.h>
+
+
+/* Private Macros ---------------------------------------------------------------*/
+/**
+ * @brief  Half period of the modelled SPI clock (ns)
+ */
+#define IC74165_SIM_SPI_HALF_NS (1000000000UL / (2 * IC74165_SIM_SPI_CLK))
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+static struct
+{
+  uint16_t ChipCount;
+  uint8_t Reg[IC74165_SIM_MAX_CHIPS];
+  uint8_t Inputs[IC74165_SIM_MAX_CHIPS];
+  uint8_t Ser;
+  uint8_t BusBusy;
+
+  // Pin levels
+  uint8_t ShLd;
+  uint8_t Clk;
+  uint8_t ClkInh;
+
+  // Simulated time and time of the last edges (ns)
+  uint64_t Now;
+  uint64_t ShLdFall;
+  uint64_t ShLdRise;
+  uint64_t ClkRise;
+  uint64_t ClkFall;
+  uint64_t QhChange;
+  // End of the transfer started by StartTransfer
+  uint64_t TransferDone;
+
+  IC74165_Sim_Timing_t Timing;
+  IC74165_Sim_Stats_t Stats;
+} IC74165_Sim = {0};
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+IC74165_Sim_Advance(uint64_t Ns)
+{
+  IC74165_Sim.Now += Ns;
+  IC74165_Sim.Stats.BusTimeNs += Ns;
+}
+
+static void
+IC74165_Sim_Load(void)
+{
+  memcpy(IC74165_Sim.Reg, IC74165_Sim.Inputs, IC74165_Sim.ChipCount);
+  IC74165_Sim.QhChange = IC74165_Sim.Now;
+}
+
+static void
+IC74165_Sim_Shift(void)
+{
+  uint16_t Last = IC74165_Sim.ChipCount - 1;
+
+  // Qh of chip i+1 drives SER of chip i
+  for (uint16_t i = 0; i < Last; i++)
+    IC74165_Sim.Reg[i] = (IC74165_Sim.Reg[i] << 1) | (IC74165_Sim.Reg[i + 1] >> 7);
+  IC74165_Sim.Reg[Last] = (IC74165_Sim.Reg[Last] << 1) | IC74165_Sim.Ser;
+
+  IC74165_Sim.QhChange = IC74165_Sim.Now;
+}
+
+/**
+ * @brief  The internal clock of 74165 is CLK OR CLK-INH.
+ */
+static void
+IC74165_Sim_ClockEdge(uint8_t Old, uint8_t New)
+{
+  uint64_t Now = IC74165_Sim.Now;
+
+  if (!Old && New)
+  {
+    IC74165_Sim.Stats.ClkEdges++;
+    if (Now - IC74165_Sim.ClkFall < IC74165_Sim.Timing.ClkLow)
+      IC74165_Sim.Stats.ClkLowViolations++;
+
+    if (IC74165_Sim.ShLd)
+    {
+      if (Now - IC74165_Sim.ShLdRise < IC74165_Sim.Timing.Hold)
+        IC74165_Sim.Stats.HoldViolations++;
+      IC74165_Sim_Shift();
+    }
+    IC74165_Sim.ClkRise = Now;
+  }
+  else if (Old && !New)
+  {
+    if (Now - IC74165_Sim.ClkRise < IC74165_Sim.Timing.ClkHigh)
+      IC74165_Sim.Stats.ClkHighViolations++;
+    IC74165_Sim.ClkFall = Now;
+  }
+}
+
+static void
+IC74165_Sim_SetClk(uint8_t Level)
+{
+  uint8_t Old = IC74165_Sim.Clk | IC74165_Sim.ClkInh;
+
+  IC74165_Sim.Clk = Level ? 1 : 0;
+  IC74165_Sim_ClockEdge(Old, IC74165_Sim.Clk | IC74165_Sim.ClkInh);
+}
+
+static void
+IC74165_Sim_SetClkInh(uint8_t Level)
+{
+  uint8_t Old = IC74165_Sim.Clk | IC74165_Sim.ClkInh;
+
+  IC74165_Sim.ClkInh = Level ? 1 : 0;
+  IC74165_Sim_ClockEdge(Old, IC74165_Sim.Clk | IC74165_Sim.ClkInh);
+}
+
+static void
+IC74165_Sim_SetShLd(uint8_t Level)
+{
+  Level = Level ? 1 : 0;
+
+  if (IC74165_Sim.ShLd && !Level)
+  {
+    IC74165_Sim.Stats.Loads++;
+    IC74165_Sim.ShLdFall = IC74165_Sim.Now;
+    IC74165_Sim_Load();
+  }
+  else if (!IC74165_Sim.ShLd && Level)
+  {
+    if (IC74165_Sim.Now - IC74165_Sim.ShLdFall < IC74165_Sim.Timing.LoadPulse)
+      IC74165_Sim.Stats.LoadPulseViolations++;
+    IC74165_Sim.ShLdRise = IC74165_Sim.Now;
+  }
+
+  IC74165_Sim.ShLd = Level;
+}
+
+static uint8_t
+IC74165_Sim_Qh(void)
+{
+  IC74165_Sim.Stats.QhReads++;
+  if (IC74165_Sim.Now - IC74165_Sim.QhChange < IC74165_Sim.Timing.Setup)
+    IC74165_Sim.Stats.SetupViolations++;
+
+  return IC74165_Sim.Reg[0] >> 7;
+}
+
+
+static void
+IC74165_PlatformInit(void)
+{
+  IC74165_Sim.Stats.Callbacks++;
+}
+
+static void
+IC74165_PlatformDeInit(void)
+{
+  IC74165_Sim.Stats.Callbacks++;
+}
+
+#if (IC74165_SIM_CLKINH_ENABLE)
+static void
+IC74165_ClkInhWrite(uint8_t Level)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+  IC74165_Sim_SetClkInh(Level);
+}
+#endif
+
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+static uint32_t
+IC74165_GetTick(void)
+{
+  // Simulated time (ns), not counted as a bus callback
+  return (uint32_t)IC74165_Sim.Now;
+}
+#endif
+
+static uint8_t
+IC74165_QhRead(void)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+  return IC74165_Sim_Qh();
+}
+
+static void
+IC74165_ClkWrite(uint8_t Level)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+  IC74165_Sim_SetClk(Level);
+}
+
+static void
+IC74165_ShLdWrite(uint8_t Level)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+  IC74165_Sim_SetShLd(Level);
+}
+
+static void
+IC74165_DelayUs(uint8_t Delay)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  IC74165_Sim_Advance(1000ULL * Delay);
+}
+
+static void
+IC74165_DelayNs(uint16_t Delay)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  IC74165_Sim_Advance(Delay);
+}
+
+static void
+IC74165_ShiftBytes(uint8_t *Data, uint8_t Count)
+{
+  IC74165_Sim.Stats.Callbacks++;
+
+  for (uint8_t i = 0; i < Count; i++)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+      Buffer |= (IC74165_Sim_Qh() << j);
+      IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+      IC74165_Sim_SetClk(1);
+      IC74165_Sim_Advance(IC74165_SIM_GPIO_NS);
+      IC74165_Sim_SetClk(0);
+    }
+
+    if (Data != NULL)
+      Data[i] = Buffer;
+  }
+}
+
+/**
+ * @brief  A blocking acquire models waiting until the other bus user is done.
+ */
+static uint8_t
+IC74165_SPI_BusAcquire(uint8_t Block)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  if (IC74165_Sim.BusBusy && !Block)
+    return 0;
+  return 1;
+}
+
+static void
+IC74165_SPI_BusRelease(void)
+{
+  IC74165_Sim.Stats.Callbacks++;
+}
+
+/**
+ * @brief  SPI mode 1: MOSI (SH/LD) changes on the rising edge of SCK, just
+ *         after the chain has seen it, and MISO (Qh) is sampled on the falling
+ *         edge.
+ */
+static void
+IC74165_SPI_SendReceive(uint8_t *SendData,
+                        uint8_t *ReceiveData,
+                        size_t Len)
+{
+  IC74165_Sim.Stats.Callbacks++;
+
+  for (size_t i = 0; i < Len; i++)
+  {
+    uint8_t Send = SendData ? SendData[i] : 0xFF;
+    uint8_t Buffer = 0;
+
+    IC74165_Sim.Stats.SpiBytes++;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      IC74165_Sim_Advance(IC74165_SIM_SPI_HALF_NS);
+      IC74165_Sim_SetClk(1);
+      IC74165_Sim_SetShLd((Send >> j) & 1);
+      IC74165_Sim_Advance(IC74165_SIM_SPI_HALF_NS);
+      Buffer |= (IC74165_Sim_Qh() << j);
+      IC74165_Sim_SetClk(0);
+    }
+
+    if (ReceiveData != NULL)
+      ReceiveData[i] = Buffer;
+  }
+}
+
+/**
+ * @brief  The transfer is modelled at once, then the simulated time goes back
+ *         to its start, so the caller runs while it is on the bus.
+ */
+static uint8_t
+IC74165_SPI_StartTransfer(uint8_t *SendData,
+                          uint8_t *ReceiveData,
+                          size_t Len)
+{
+  uint64_t Start = IC74165_Sim.Now;
+
+  IC74165_SPI_SendReceive(SendData, ReceiveData, Len);
+  IC74165_Sim.TransferDone = IC74165_Sim.Now;
+  IC74165_Sim.Now = Start;
+
+  return 1;
+}
+
+static uint8_t
+IC74165_SPI_IsComplete(void)
+{
+  IC74165_Sim.Stats.Callbacks++;
+  return (IC74165_Sim.Now >= IC74165_Sim.TransferDone) ? 1 : 0;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with the simulated
+ *         chain using GPIO and DelayUs.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init(IC74165_Handler_t *Handler)
+{
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_GPIO);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit);
+#if (IC74165_SIM_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_GPIO_CLKWRITE(Handler, IC74165_ClkWrite);
+  IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(Handler, IC74165_ShLdWrite);
+  IC74165_PLATFORM_LINK_GPIO_QHREAD(Handler, IC74165_QhRead);
+  IC74165_PLATFORM_LINK_GPIO_DELAYUS(Handler, IC74165_DelayUs);
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+  IC74165_PLATFORM_LINK_GETTICK(Handler, IC74165_GetTick);
+#endif
+}
+
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with the simulated
+ *         chain using GPIO, DelayNs and ShiftBytes.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_Fast(IC74165_Handler_t *Handler)
+{
+  IC74165_Platform_Init(Handler);
+  IC74165_PLATFORM_LINK_GPIO_DELAYNS(Handler, IC74165_DelayNs);
+  IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(Handler, IC74165_ShiftBytes);
+  IC74165_PLATFORM_SET_GPIO_EDGELATENCY(Handler, IC74165_SIM_GPIO_NS);
+}
+
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with the simulated
+ *         chain using SPI (mode 1, MOSI to SH/LD, CS to CLK-INH).
+ * @note   StartTransfer/IsComplete are linked; use IC74165_Sim_Wait to model
+ *         the work done while an asynchronous read is on the bus.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler)
+{
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_SPI);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit);
+#if (IC74165_SIM_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_SPI_SENDRECEIVEWIDE(Handler, IC74165_SPI_SendReceive);
+  IC74165_PLATFORM_LINK_SPI_STARTTRANSFER(Handler, IC74165_SPI_StartTransfer);
+  IC74165_PLATFORM_LINK_SPI_ISCOMPLETE(Handler, IC74165_SPI_IsComplete);
+  IC74165_PLATFORM_LINK_BUSACQUIRE(Handler, IC74165_SPI_BusAcquire);
+  IC74165_PLATFORM_LINK_BUSRELEASE(Handler, IC74165_SPI_BusRelease);
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+  IC74165_PLATFORM_LINK_GETTICK(Handler, IC74165_GetTick);
+#endif
+}
+
+
+/**
+ * @brief  Reset the model.
+ * @note   All parallel inputs, SER and counters are cleared and the timing
+ *         limits are set to the default values.
+ * @param  ChipCount: Number of chained 74165 (1 to IC74165_SIM_MAX_CHIPS)
+ * @retval None
+ */
+void
+IC74165_Sim_Reset(uint16_t ChipCount)
+{
+  const IC74165_Sim_Timing_t Timing =
+  {
+    .LoadPulse = IC74165_SIM_LOAD_PULSE_NS,
+    .ClkHigh = IC74165_SIM_CLK_HIGH_NS,
+    .ClkLow = IC74165_SIM_CLK_LOW_NS,
+    .Setup = IC74165_SIM_SETUP_NS,
+    .Hold = IC74165_SIM_HOLD_NS
+  };
+
+  if (ChipCount == 0)
+    ChipCount = 1;
+  if (ChipCount > IC74165_SIM_MAX_CHIPS)
+    ChipCount = IC74165_SIM_MAX_CHIPS;
+
+  memset(&IC74165_Sim, 0, sizeof(IC74165_Sim));
+  IC74165_Sim.ChipCount = ChipCount;
+  IC74165_Sim.Timing = Timing;
+  IC74165_Sim.ShLd = 1;
+  IC74165_Sim.ClkInh = IC74165_SIM_CLKINH_ENABLE ? 1 : 0;
+
+  // Start far from the zeroed edge times, so the first edges are not violations
+  IC74165_Sim.Now = 1000000;
+}
+
+
+/**
+ * @brief  Set timing limits of the model.
+ * @param  Timing: Pointer to timing limits
+ * @retval None
+ */
+void
+IC74165_Sim_SetTiming(const IC74165_Sim_Timing_t *Timing)
+{
+  IC74165_Sim.Timing = *Timing;
+}
+
+
+/**
+ * @brief  Set parallel inputs (A to H) of a chip.
+ * @param  Chip: Position of the chip in chain. Chip 0 drives Qh of the chain.
+ * @param  Value: Input levels. Bit 7 is H, bit 0 is A.
+ * @retval None
+ */
+void
+IC74165_Sim_SetInputs(uint16_t Chip, uint8_t Value)
+{
+  if (Chip >= IC74165_Sim.ChipCount)
+    return;
+
+  IC74165_Sim.Inputs[Chip] = Value;
+
+  // The register follows the inputs while SH/LD is low
+  if (!IC74165_Sim.ShLd)
+    IC74165_Sim_Load();
+}
+
+
+/**
+ * @brief  Set level of SER pin of the last chip.
+ * @param  Level: 0 or 1
+ * @retval None
+ */
+void
+IC74165_Sim_SetSer(uint8_t Level)
+{
+  IC74165_Sim.Ser = Level ? 1 : 0;
+}
+
+
+/**
+ * @brief  Advance the simulated time without bus activity.
+ * @note   It models work of the application between two calls to the driver.
+ * @param  Ns: Duration (ns)
+ * @retval None
+ */
+void
+IC74165_Sim_Wait(uint32_t Ns)
+{
+  IC74165_Sim.Now += Ns;
+}
+
+
+/**
+ * @brief  Mark the SPI bus as used by another device.
+ * @note   A non-blocking BusAcquire fails while it is set.
+ * @param  Busy: 0 or 1
+ * @retval None
+ */
+void
+IC74165_Sim_SetBusBusy(uint8_t Busy)
+{
+  IC74165_Sim.BusBusy = Busy ? 1 : 0;
+}
+
+
+/**
+ * @brief  Get counters of the model.
+ * @param  Stats: Pointer to store counters
+ * @retval None
+ */
+void
+IC74165_Sim_GetStats(IC74165_Sim_Stats_t *Stats)
+{
+  *Stats = IC74165_Sim.Stats;
+}
+
+
+/**
+ * @brief  Clear counters of the model.
+ * @retval None
+ */
+void
+IC74165_Sim_ResetStats(void)
+{
+  memset(&IC74165_Sim.Stats, 0, sizeof(IC74165_Sim.Stats));
+}
@@ -0,0 +1,247 @@
+/**
+ **********************************************************************************
+ * @file   74165_platform.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Simulated platform dependent layer for 74165 Driver
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+  
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _74165_PLATFORM_H_
+#define _74165_PLATFORM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "74165.h"
+#include <stdint.h>
+
+
+/* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Maximum number of simulated 74165 in the chain
+ */
+#define IC74165_SIM_MAX_CHIPS 1024
+
+/**
+ * @brief  Modelled duration of one GPIO callback (ns). Every pin write or read
+ *         advances the simulated time by this value.
+ */
+#define IC74165_SIM_GPIO_NS   20
+
+/**
+ * @brief  Modelled SPI clock (Hz)
+ */
+#define IC74165_SIM_SPI_CLK   10000000UL
+
+/**
+ * @brief  Link CLK-INH write function
+ */
+#define IC74165_SIM_CLKINH_ENABLE 1
+
+/**
+ * @brief  Default timing limits of the model (ns), 74HC165 at 4.5V
+ */
+#define IC74165_SIM_LOAD_PULSE_NS 20
+#define IC74165_SIM_CLK_HIGH_NS   20
+#define IC74165_SIM_CLK_LOW_NS    20
+#define IC74165_SIM_SETUP_NS      40
+#define IC74165_SIM_HOLD_NS       20
+
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  Timing limits of the model (ns)
+ */
+typedef struct IC74165_Sim_Timing_s
+{
+  // Minimum pulse width of SH/LD low level
+  uint16_t LoadPulse;
+  // Minimum pulse width of CLK high level
+  uint16_t ClkHigh;
+  // Minimum pulse width of CLK low level
+  uint16_t ClkLow;
+  // Propagation delay of Qh after SH/LD or CLK edge. Qh must not be read
+  // earlier.
+  uint16_t Setup;
+  // Minimum time that SH/LD must be high before the next CLK rising edge
+  uint16_t Hold;
+} IC74165_Sim_Timing_t;
+
+/**
+ * @brief  Counters of the model
+ * @note   Clock edges are counted on the internal clock of 74165 (CLK OR
+ *         CLK-INH), so they include edges caused by CLK-INH.
+ */
+typedef struct IC74165_Sim_Stats_s
+{
+  // Number of platform callbacks called by the driver
+  uint32_t Callbacks;
+  // Number of rising edges of the internal clock
+  uint32_t ClkEdges;
+  // Number of parallel loads (SH/LD falling edges)
+  uint32_t Loads;
+  // Number of Qh samples (GPIO reads and SPI bits)
+  uint32_t QhReads;
+  // Number of bytes transferred through SPI
+  uint32_t SpiBytes;
+  // Modelled bus time (ns)
+  uint64_t BusTimeNs;
+
+  // Timing violations
+  uint32_t LoadPulseViolations;
+  uint32_t ClkHighViolations;
+  uint32_t ClkLowViolations;
+  uint32_t SetupViolations;
+  uint32_t HoldViolations;
+} IC74165_Sim_Stats_t;
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with the simulated
+ *         chain using GPIO and DelayUs.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with the simulated
+ *         chain using GPIO, DelayNs and ShiftBytes.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_Fast(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with the simulated
+ *         chain using SPI (mode 1, MOSI to SH/LD, CS to CLK-INH).
+ * @note   StartTransfer/IsComplete are linked; use IC74165_Sim_Wait to model
+ *         the work done while an asynchronous read is on the bus.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Reset the model.
+ * @note   All parallel inputs, SER and counters are cleared and the timing
+ *         limits are set to the default values.
+ * @param  ChipCount: Number of chained 74165 (1 to IC74165_SIM_MAX_CHIPS)
+ * @retval None
+ */
+void
+IC74165_Sim_Reset(uint16_t ChipCount);
+
+
+/**
+ * @brief  Set timing limits of the model.
+ * @param  Timing: Pointer to timing limits
+ * @retval None
+ */
+void
+IC74165_Sim_SetTiming(const IC74165_Sim_Timing_t *Timing);
+
+
+/**
+ * @brief  Set parallel inputs (A to H) of a chip.
+ * @param  Chip: Position of the chip in chain. Chip 0 drives Qh of the chain.
+ * @param  Value: Input levels. Bit 7 is H, bit 0 is A.
+ * @retval None
+ */
+void
+IC74165_Sim_SetInputs(uint16_t Chip, uint8_t Value);
+
+
+/**
+ * @brief  Set level of SER pin of the last chip.
+ * @param  Level: 0 or 1
+ * @retval None
+ */
+void
+IC74165_Sim_SetSer(uint8_t Level);
+
+
+/**
+ * @brief  Advance the simulated time without bus activity.
+ * @note   It models work of the application between two calls to the driver.
+ * @param  Ns: Duration (ns)
+ * @retval None
+ */
+void
+IC74165_Sim_Wait(uint32_t Ns);
+
+
+/**
+ * @brief  Mark the SPI bus as used by another device.
+ * @note   A non-blocking BusAcquire fails while it is set.
+ * @param  Busy: 0 or 1
+ * @retval None
+ */
+void
+IC74165_Sim_SetBusBusy(uint8_t Busy);
+
+
+/**
+ * @brief  Get counters of the model.
+ * @param  Stats: Pointer to store counters
+ * @retval None
+ */
+void
+IC74165_Sim_GetStats(IC74165_Sim_Stats_t *Stats);
+
+
+/**
+ * @brief  Clear counters of the model.
+ * @retval None
+ */
+void
+IC74165_Sim_ResetStats(void);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //! _74165_PLATFORM_H_
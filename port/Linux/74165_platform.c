@@ -0,0 +1,587 @@
+/**
+ **********************************************************************************
+ * @file   74165_platform.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  A sample Platform dependent layer for 74165 Driver
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+  
+/* Includes ---------------------------------------------------------------------*/
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "74165_platform.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include <gpiod.h>
+
+
+/* Private Macros ---------------------------------------------------------------*/
+// Missing in the headers of kernels older than 6.4
+#ifndef SPI_MOSI_IDLE_HIGH
+#define SPI_MOSI_IDLE_HIGH  (1U << 17)
+#endif
+
+
+/* Private Variables ------------------------------------------------------------*/
+static struct gpiod_chip *IC74165_Chip = NULL;
+static struct gpiod_line_request *IC74165_Request = NULL;
+// Handler of the GPIO mode, for the CLK phases of ShiftBytes
+static IC74165_Handler_t *IC74165_Handler = NULL;
+
+static const unsigned int IC74165_MultiLines[] = IC74165_MULTI_QH_LINES;
+#define IC74165_MULTI_LINE_COUNT \
+  (sizeof(IC74165_MultiLines) / sizeof(IC74165_MultiLines[0]))
+
+// SH/LD rising edge waiting to be written together with CLK-INH falling edge
+static uint8_t IC74165_ShLdPending = 0;
+
+static int IC74165_SPI_Fd = -1;
+// 0xFF bytes sent while shifting (SH/LD high)
+static uint8_t *IC74165_SPI_Ones = NULL;
+static size_t IC74165_SPI_OnesLen = 0;
+// Send-only transfer (parallel load) waiting to be sent with the next one
+static uint8_t IC74165_SPI_LoadBuff[4];
+static size_t IC74165_SPI_LoadLen = 0;
+// A transfer failed since the last GetError
+static uint8_t IC74165_SPI_Error = 0;
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+IC74165_RequestLines(const unsigned int *Inputs, size_t InputCount)
+{
+  struct gpiod_line_settings *Settings = NULL;
+  struct gpiod_line_config *LineConfig = NULL;
+  struct gpiod_request_config *ReqConfig = NULL;
+  const unsigned int ClkLine = IC74165_CLK_LINE;
+  const unsigned int IdleHighLines[] =
+  {
+    IC74165_SHLD_LINE,
+#if (IC74165_CLKINH_ENABLE)
+    IC74165_CLKINH_LINE,
+#endif
+  };
+
+  IC74165_Chip = gpiod_chip_open(IC74165_GPIO_CHIP);
+  if (IC74165_Chip == NULL)
+  {
+    perror("74165: " IC74165_GPIO_CHIP);
+    return;
+  }
+
+  Settings = gpiod_line_settings_new();
+  LineConfig = gpiod_line_config_new();
+  ReqConfig = gpiod_request_config_new();
+  if (Settings == NULL || LineConfig == NULL || ReqConfig == NULL)
+    goto Free;
+
+  // All lines are in one request, so a multi-line write or read is one ioctl
+  gpiod_line_settings_set_direction(Settings, GPIOD_LINE_DIRECTION_OUTPUT);
+  gpiod_line_settings_set_output_value(Settings, GPIOD_LINE_VALUE_INACTIVE);
+  if (gpiod_line_config_add_line_settings(LineConfig, &ClkLine, 1, Settings) < 0)
+    goto Free;
+
+  gpiod_line_settings_set_output_value(Settings, GPIOD_LINE_VALUE_ACTIVE);
+  if (gpiod_line_config_add_line_settings(LineConfig, IdleHighLines,
+                                          sizeof(IdleHighLines) / sizeof(IdleHighLines[0]),
+                                          Settings) < 0)
+    goto Free;
+
+  gpiod_line_settings_reset(Settings);
+  gpiod_line_settings_set_direction(Settings, GPIOD_LINE_DIRECTION_INPUT);
+  if (gpiod_line_config_add_line_settings(LineConfig, Inputs, InputCount, Settings) < 0)
+    goto Free;
+
+  gpiod_request_config_set_consumer(ReqConfig, IC74165_CONSUMER);
+  IC74165_Request = gpiod_chip_request_lines(IC74165_Chip, ReqConfig, LineConfig);
+
+Free:
+  if (IC74165_Request == NULL)
+  {
+    perror("74165: request lines");
+    gpiod_chip_close(IC74165_Chip);
+    IC74165_Chip = NULL;
+  }
+  gpiod_request_config_free(ReqConfig);
+  gpiod_line_config_free(LineConfig);
+  gpiod_line_settings_free(Settings);
+}
+
+static void
+IC74165_PlatformInit(void)
+{
+  const unsigned int QhLine = IC74165_QH_LINE;
+  IC74165_RequestLines(&QhLine, 1);
+}
+
+static void
+IC74165_PlatformInit_Multi(void)
+{
+  IC74165_RequestLines(IC74165_MultiLines, IC74165_MULTI_LINE_COUNT);
+}
+
+#if (IC74165_CLKINH_ENABLE)
+static void
+IC74165_RequestClkInh(void)
+{
+  struct gpiod_line_settings *Settings = NULL;
+  struct gpiod_line_config *LineConfig = NULL;
+  struct gpiod_request_config *ReqConfig = NULL;
+  const unsigned int ClkInhLine = IC74165_CLKINH_LINE;
+
+  IC74165_Chip = gpiod_chip_open(IC74165_GPIO_CHIP);
+  if (IC74165_Chip == NULL)
+  {
+    perror("74165: " IC74165_GPIO_CHIP);
+    return;
+  }
+
+  Settings = gpiod_line_settings_new();
+  LineConfig = gpiod_line_config_new();
+  ReqConfig = gpiod_request_config_new();
+  if (Settings == NULL || LineConfig == NULL || ReqConfig == NULL)
+    goto Free;
+
+  gpiod_line_settings_set_direction(Settings, GPIOD_LINE_DIRECTION_OUTPUT);
+  gpiod_line_settings_set_output_value(Settings, GPIOD_LINE_VALUE_ACTIVE);
+  if (gpiod_line_config_add_line_settings(LineConfig, &ClkInhLine, 1, Settings) < 0)
+    goto Free;
+
+  gpiod_request_config_set_consumer(ReqConfig, IC74165_CONSUMER);
+  IC74165_Request = gpiod_chip_request_lines(IC74165_Chip, ReqConfig, LineConfig);
+
+Free:
+  if (IC74165_Request == NULL)
+  {
+    perror("74165: request lines");
+    gpiod_chip_close(IC74165_Chip);
+    IC74165_Chip = NULL;
+  }
+  gpiod_request_config_free(ReqConfig);
+  gpiod_line_config_free(LineConfig);
+  gpiod_line_settings_free(Settings);
+}
+#endif
+
+static void
+IC74165_PlatformDeInit(void)
+{
+  if (IC74165_Request)
+    gpiod_line_request_release(IC74165_Request);
+  if (IC74165_Chip)
+    gpiod_chip_close(IC74165_Chip);
+  IC74165_Request = NULL;
+  IC74165_Chip = NULL;
+  IC74165_ShLdPending = 0;
+}
+
+static inline void
+IC74165_SetLine(unsigned int Line, uint8_t Level)
+{
+  if (IC74165_Request)
+    gpiod_line_request_set_value(IC74165_Request, Line,
+                                 Level ? GPIOD_LINE_VALUE_ACTIVE :
+                                         GPIOD_LINE_VALUE_INACTIVE);
+}
+
+static inline void
+IC74165_ShLdFlush(void)
+{
+  if (IC74165_ShLdPending)
+  {
+    IC74165_ShLdPending = 0;
+    IC74165_SetLine(IC74165_SHLD_LINE, 1);
+  }
+}
+
+#if (IC74165_CLKINH_ENABLE)
+static void
+IC74165_ClkInhWrite(uint8_t Level)
+{
+  static const unsigned int Lines[] = {IC74165_SHLD_LINE, IC74165_CLKINH_LINE};
+  static const enum gpiod_line_value Values[] =
+      {GPIOD_LINE_VALUE_ACTIVE, GPIOD_LINE_VALUE_INACTIVE};
+
+  // End of parallel load and start of shift: both edges in one ioctl. CLK is
+  // low, so the order of the two edges does not matter.
+  if (IC74165_ShLdPending && Level == 0 && IC74165_Request)
+  {
+    IC74165_ShLdPending = 0;
+    gpiod_line_request_set_values_subset(IC74165_Request, 2, Lines, Values);
+    return;
+  }
+
+  IC74165_ShLdFlush();
+  IC74165_SetLine(IC74165_CLKINH_LINE, Level);
+}
+#endif
+
+static uint8_t
+IC74165_QhRead(void)
+{
+  IC74165_ShLdFlush();
+  if (IC74165_Request == NULL)
+    return 0;
+  return (gpiod_line_request_get_value(IC74165_Request, IC74165_QH_LINE) ==
+          GPIOD_LINE_VALUE_ACTIVE) ? 1 : 0;
+}
+
+static uint32_t
+IC74165_PortRead(void)
+{
+  enum gpiod_line_value Values[IC74165_MULTI_LINE_COUNT];
+  uint32_t Port = 0;
+
+  IC74165_ShLdFlush();
+  if (IC74165_Request == NULL ||
+      gpiod_line_request_get_values_subset(IC74165_Request, IC74165_MULTI_LINE_COUNT,
+                                           IC74165_MultiLines, Values) < 0)
+    return 0;
+
+  for (size_t i = 0; i < IC74165_MULTI_LINE_COUNT; i++)
+    if (Values[i] == GPIOD_LINE_VALUE_ACTIVE)
+      Port |= (1UL << i);
+
+  return Port;
+}
+
+static void
+IC74165_ClkWrite(uint8_t Level)
+{
+  IC74165_ShLdFlush();
+  IC74165_SetLine(IC74165_CLK_LINE, Level);
+}
+
+static void
+IC74165_ShLdWrite(uint8_t Level)
+{
+#if (IC74165_CLKINH_ENABLE)
+  // Wait for the CLK-INH write of the shift, if it comes next
+  if (Level)
+  {
+    IC74165_ShLdPending = 1;
+    return;
+  }
+#endif
+  IC74165_ShLdPending = 0;
+  IC74165_SetLine(IC74165_SHLD_LINE, Level);
+}
+
+static void
+IC74165_BusyWait(long Ns)
+{
+  struct timespec Start, Now;
+  long Elapsed;
+
+  // nanosleep sleeps for at least one scheduler tick; spin instead
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  do
+  {
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    Elapsed = (Now.tv_sec - Start.tv_sec) * 1000000000L +
+              (Now.tv_nsec - Start.tv_nsec);
+  } while (Elapsed < Ns);
+}
+
+static void
+IC74165_DelayNs(uint16_t Delay)
+{
+  IC74165_BusyWait(Delay);
+}
+
+static void
+IC74165_DelayUs(uint8_t Delay)
+{
+  IC74165_BusyWait(1000L * Delay);
+}
+
+static void
+IC74165_ShiftBytes(uint8_t *Data, uint8_t Count)
+{
+  static const unsigned int ClkLine = IC74165_CLK_LINE;
+  static const unsigned int QhLine = IC74165_QH_LINE;
+  static const enum gpiod_line_value High = GPIOD_LINE_VALUE_ACTIVE;
+  static const enum gpiod_line_value Low = GPIOD_LINE_VALUE_INACTIVE;
+  long ClkHigh = IC74165_Handler->Delay.ClkHigh;
+  long ClkLow = IC74165_Handler->Delay.ClkLow;
+  enum gpiod_line_value Qh = GPIOD_LINE_VALUE_INACTIVE;
+
+  IC74165_ShLdFlush();
+
+  // The v2 uAPI has no ioctl that sets and gets together, so a bit stays at
+  // three: Qh read, CLK high and CLK low
+  for (; Count; --Count)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      if (IC74165_Request)
+      {
+        gpiod_line_request_get_values_subset(IC74165_Request, 1, &QhLine, &Qh);
+        gpiod_line_request_set_values_subset(IC74165_Request, 1, &ClkLine, &High);
+      }
+      if (ClkHigh)
+        IC74165_BusyWait(ClkHigh);
+      if (IC74165_Request)
+        gpiod_line_request_set_values_subset(IC74165_Request, 1, &ClkLine, &Low);
+      if (ClkLow)
+        IC74165_BusyWait(ClkLow);
+
+      Buffer = (uint8_t)(Buffer << 1) | (Qh == GPIOD_LINE_VALUE_ACTIVE);
+    }
+
+    if (Data != NULL)
+      *Data++ = Buffer;
+  }
+}
+
+static void
+IC74165_PlatformInit_SPI(void)
+{
+#if (IC74165_SPI_MOSI_IDLE_HIGH)
+  uint32_t Mode = SPI_MODE_1 | SPI_MOSI_IDLE_HIGH;
+#else
+  uint32_t Mode = SPI_MODE_1;
+#endif
+  uint32_t ModeRead = 0;
+  uint8_t Bits = 8;
+  uint32_t Speed = IC74165_SPI_SPEED;
+
+  IC74165_SPI_Error = 0;
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_RequestClkInh();
+#endif
+
+  IC74165_SPI_Fd = open(IC74165_SPI_DEVICE, O_RDWR);
+  if (IC74165_SPI_Fd < 0)
+  {
+    perror("74165: " IC74165_SPI_DEVICE);
+    return;
+  }
+
+  if (ioctl(IC74165_SPI_Fd, SPI_IOC_WR_MODE32, &Mode) < 0 ||
+      ioctl(IC74165_SPI_Fd, SPI_IOC_RD_MODE32, &ModeRead) < 0 ||
+      ioctl(IC74165_SPI_Fd, SPI_IOC_WR_BITS_PER_WORD, &Bits) < 0 ||
+      ioctl(IC74165_SPI_Fd, SPI_IOC_WR_MAX_SPEED_HZ, &Speed) < 0)
+  {
+    perror("74165: spidev setup");
+    goto Fail;
+  }
+
+  // The driver may drop mode bits the controller does not support
+  if (ModeRead != Mode)
+  {
+    fprintf(stderr, "74165: " IC74165_SPI_DEVICE " does not keep MOSI high when idle\n");
+    goto Fail;
+  }
+  return;
+
+Fail:
+  close(IC74165_SPI_Fd);
+  IC74165_SPI_Fd = -1;
+}
+
+static void
+IC74165_SPI_SendReceive(uint8_t *SendData,
+                        uint8_t *ReceiveData,
+                        size_t Len)
+{
+  struct spi_ioc_transfer Xfer[2];
+  unsigned int Count = 0;
+
+  if (Len == 0)
+    return;
+
+  if (IC74165_SPI_Fd < 0)
+  {
+    IC74165_SPI_Error = 1;
+    return;
+  }
+
+  // A send-only transfer is the parallel load. Keep it and send it with the
+  // shift that follows, as one message.
+  if (ReceiveData == NULL && SendData != NULL && IC74165_SPI_LoadLen == 0 &&
+      Len <= sizeof(IC74165_SPI_LoadBuff))
+  {
+    memcpy(IC74165_SPI_LoadBuff, SendData, Len);
+    IC74165_SPI_LoadLen = Len;
+    return;
+  }
+
+  if (SendData == NULL && IC74165_SPI_OnesLen < Len)
+  {
+    uint8_t *Ones = realloc(IC74165_SPI_Ones, Len);
+    if (Ones == NULL)
+    {
+      IC74165_SPI_LoadLen = 0;
+      IC74165_SPI_Error = 1;
+      return;
+    }
+    memset(Ones, 0xFF, Len);
+    IC74165_SPI_Ones = Ones;
+    IC74165_SPI_OnesLen = Len;
+  }
+
+  memset(Xfer, 0, sizeof(Xfer));
+  if (IC74165_SPI_LoadLen)
+  {
+    Xfer[Count].tx_buf = (uintptr_t)IC74165_SPI_LoadBuff;
+    Xfer[Count].len = IC74165_SPI_LoadLen;
+    Xfer[Count].speed_hz = IC74165_SPI_SPEED;
+    Xfer[Count].bits_per_word = 8;
+    Count++;
+    IC74165_SPI_LoadLen = 0;
+  }
+
+  Xfer[Count].tx_buf = (uintptr_t)(SendData ? SendData : IC74165_SPI_Ones);
+  Xfer[Count].rx_buf = (uintptr_t)ReceiveData;
+  Xfer[Count].len = Len;
+  Xfer[Count].speed_hz = IC74165_SPI_SPEED;
+  Xfer[Count].bits_per_word = 8;
+  Count++;
+
+  if (ioctl(IC74165_SPI_Fd, SPI_IOC_MESSAGE(Count), Xfer) < 0)
+    IC74165_SPI_Error = 1;
+}
+
+static uint8_t
+IC74165_SPI_GetError(void)
+{
+  uint8_t Error = IC74165_SPI_Error;
+  IC74165_SPI_Error = 0;
+  return Error;
+}
+
+static void
+IC74165_PlatformDeInit_SPI(void)
+{
+  if (IC74165_SPI_Fd >= 0 && IC74165_SPI_LoadLen)
+  {
+    struct spi_ioc_transfer Xfer;
+
+    memset(&Xfer, 0, sizeof(Xfer));
+    Xfer.tx_buf = (uintptr_t)IC74165_SPI_LoadBuff;
+    Xfer.len = IC74165_SPI_LoadLen;
+    Xfer.speed_hz = IC74165_SPI_SPEED;
+    Xfer.bits_per_word = 8;
+    ioctl(IC74165_SPI_Fd, SPI_IOC_MESSAGE(1), &Xfer);
+  }
+  IC74165_SPI_LoadLen = 0;
+
+  if (IC74165_SPI_Fd >= 0)
+    close(IC74165_SPI_Fd);
+  IC74165_SPI_Fd = -1;
+
+  free(IC74165_SPI_Ones);
+  IC74165_SPI_Ones = NULL;
+  IC74165_SPI_OnesLen = 0;
+
+  IC74165_PlatformDeInit();
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         GPIO lines of libgpiod v2.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init(IC74165_Handler_t *Handler)
+{
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_GPIO);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit);
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_GPIO_CLKWRITE(Handler, IC74165_ClkWrite);
+  IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(Handler, IC74165_ShLdWrite);
+  IC74165_PLATFORM_LINK_GPIO_QHREAD(Handler, IC74165_QhRead);
+  IC74165_PLATFORM_LINK_GPIO_DELAYUS(Handler, IC74165_DelayUs);
+  IC74165_PLATFORM_LINK_GPIO_DELAYNS(Handler, IC74165_DelayNs);
+  IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(Handler, IC74165_ShiftBytes);
+  IC74165_PLATFORM_SET_GPIO_EDGELATENCY(Handler, IC74165_EDGE_LATENCY);
+  IC74165_Handler = Handler;
+}
+
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         spidev.
+ * @note   CLK-INH is driven through IC74165_CLKINH_LINE, not the CS of spidev.
+ *         The kernel releases CS between messages, and a CLK-INH rising edge
+ *         while CLK is low shifts the chain once.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler)
+{
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_SPI);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit_SPI);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit_SPI);
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_SPI_SENDRECEIVEWIDE(Handler, IC74165_SPI_SendReceive);
+  IC74165_PLATFORM_LINK_SPI_GETERROR(Handler, IC74165_SPI_GetError);
+}
+
+
+/**
+ * @brief  Initialize platform dependent layer of a multi-chain handler. The Qh
+ *         lines of all chains (IC74165_MULTI_QH_LINES) are read in one ioctl.
+ * @param  Multi: Pointer to multi-chain handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_Multi(IC74165_Multi_t *Multi)
+{
+  IC74165_Platform_Init(&Multi->Handler);
+  IC74165_PLATFORM_LINK_INIT(&Multi->Handler, IC74165_PlatformInit_Multi);
+  IC74165_PLATFORM_LINK_MULTI_PORTREAD(Multi, IC74165_PortRead);
+}
@@ -0,0 +1,143 @@
+/**
+ **********************************************************************************
+ * @file   74165_platform.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  A sample Platform dependent layer for 74165 Driver
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+  
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _74165_PLATFORM_H_
+#define _74165_PLATFORM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Includes ---------------------------------------------------------------------*/
+#include "74165.h"
+#include <stdint.h>
+
+
+/* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Specify GPIO chip and line offsets connected to 74165
+ * @note   To test without hardware, load gpio-sim and point IC74165_GPIO_CHIP
+ *         to the simulated chip. Qh levels can then be set through the pull
+ *         attributes of gpio-sim in sysfs.
+ */
+#define IC74165_GPIO_CHIP     "/dev/gpiochip0"
+#define IC74165_CLK_LINE      17
+#define IC74165_SHLD_LINE     27
+#define IC74165_QH_LINE       22
+#define IC74165_CLKINH_LINE   23
+#define IC74165_CLKINH_ENABLE 0
+#define IC74165_CONSUMER      "74165"
+
+/**
+ * @brief  Qh lines of the chains in multi-chain mode (IC74165_Platform_Init_Multi).
+ *         Line n is the Qh pin of chain n.
+ */
+#define IC74165_MULTI_QH_LINES  {22, 5, 6, 13}
+
+/**
+ * @brief  Time of one GPIO ioctl (ns). Delays of the timing profile that are
+ *         shorter than this are skipped.
+ */
+#define IC74165_EDGE_LATENCY  1000
+
+/**
+ * @brief  SPI options
+ *         - IC74165_SPI_DEVICE: spidev device. MOSI, MISO and SCLK must be
+ *           connected to SH/LD, Qh and CLK pins of 74165. CS is not used;
+ *           CLK-INH is IC74165_CLKINH_LINE (or tied low if
+ *           IC74165_CLKINH_ENABLE is 0).
+ *         - IC74165_SPI_SPEED: SPI clock (Hz)
+ *         - IC74165_SPI_MOSI_IDLE_HIGH: 1 to request SPI_MOSI_IDLE_HIGH
+ *           (Linux 6.4 and above). If the controller driver does not support
+ *           it, Init leaves the port closed and every read fails. Set it to 0
+ *           only if MOSI is known to keep the last bit sent between messages.
+ * @note   SH/LD (MOSI) must stay high between the messages of a scan. The skip,
+ *         data and integrity tail of a scan are separate messages, and stream
+ *         and plan reads use the data between them, so they cannot be sent as
+ *         one message. If MOSI went low between them, the chain would load
+ *         again in the middle of the scan.
+ * @note   spidev limits one message to its bufsiz module parameter (4096 bytes
+ *         by default). Raise it for chains longer than 4095 devices.
+ * @note   With MOSI and MISO connected together (loopback), every read returns
+ *         0xFF bytes. It is enough to check the transfers without a chain.
+ */
+#define IC74165_SPI_DEVICE    "/dev/spidev0.0"
+#define IC74165_SPI_SPEED     1000000
+#define IC74165_SPI_MOSI_IDLE_HIGH  1
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         GPIO lines of libgpiod v2.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         spidev.
+ * @note   CLK-INH is driven through IC74165_CLKINH_LINE, not the CS of spidev.
+ *         The kernel releases CS between messages, and a CLK-INH rising edge
+ *         while CLK is low shifts the chain once.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Initialize platform dependent layer of a multi-chain handler. The Qh
+ *         lines of all chains (IC74165_MULTI_QH_LINES) are read in one ioctl.
+ * @param  Multi: Pointer to multi-chain handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_Multi(IC74165_Multi_t *Multi);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //! _74165_PLATFORM_H_
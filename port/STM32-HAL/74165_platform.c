@@ -31,8 +31,60 @@
 /* Includes ---------------------------------------------------------------------*/
 #include "74165_platform.h"
 #include "main.h"
+#include <string.h>
 
 
+#if (IC74165_DELAY_DWT) && defined(__CORTEX_M) && (__CORTEX_M < 3U)
+#error "IC74165_DELAY_DWT needs the DWT cycle counter (Cortex-M3 and above)"
+#endif
+
+#if (IC74165_SPI_ENABLE) && !defined(HAL_SPI_MODULE_ENABLED)
+#error "IC74165_SPI_ENABLE needs HAL_SPI_MODULE_ENABLED"
+#endif
+
+#if (IC74165_SPI_ENABLE) && defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define IC74165_SPI_DCACHE 1
+#else
+#define IC74165_SPI_DCACHE 0
+#endif
+
+/**
+ * @brief  CPU cycles of one delay tick: one cycle of the DWT counter, or one
+ *         iteration of the software loop
+ */
+#if (IC74165_DELAY_DWT)
+#define IC74165_DELAY_TICK_CYCLES 1
+#else
+#define IC74165_DELAY_TICK_CYCLES IC74165_DELAY_LOOP_CYCLES
+#endif
+
+
+/* Private Variables ------------------------------------------------------------*/
+#if (IC74165_SPI_ENABLE)
+extern SPI_HandleTypeDef IC74165_SPI_HANDLE;
+
+// Aligned to cache lines, so cache maintenance does not touch other data
+static uint8_t IC74165_SPI_TxBuff[IC74165_SPI_BUFFER_SIZE] __attribute__((aligned(32)));
+static uint8_t IC74165_SPI_RxBuff[IC74165_SPI_BUFFER_SIZE] __attribute__((aligned(32)));
+static volatile uint8_t IC74165_SPI_Busy = 0;
+// A transfer failed since the last GetError
+static volatile uint8_t IC74165_SPI_Error = 0;
+#if (IC74165_SPI_DCACHE)
+// Receive buffer of the running transfer, invalidated when it completes
+static uint8_t *IC74165_SPI_RxAddr = NULL;
+static size_t IC74165_SPI_RxLen = 0;
+#endif
+#endif
+
+static uint32_t IC74165_CyclesPerUs = 0;
+#if (IC74165_DELAY_DWT)
+static uint16_t IC74165_EdgeCostNs = 0;
+#endif
+// Handler of the GPIO mode and its CLK phases in delay ticks, set at init
+static IC74165_Handler_t *IC74165_Handler = NULL;
+static uint32_t IC74165_ClkHighTicks = 0;
+static uint32_t IC74165_ClkLowTicks = 0;
+
 
 /**
  ==================================================================================
@@ -46,7 +98,7 @@ void IC74165_SetGPIO_OUT(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
   GPIO_InitStruct.Pin = GPIO_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  GPIO_InitStruct.Speed = IC74165_GPIO_SPEED;
   HAL_GPIO_Init(GPIOx, &GPIO_InitStruct);
 }
 									
@@ -56,7 +108,7 @@ void IC74165_SetGPIO_IN(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
   GPIO_InitStruct.Pin = GPIO_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  GPIO_InitStruct.Speed = IC74165_GPIO_SPEED;
   HAL_GPIO_Init(GPIOx, &GPIO_InitStruct);
 }
 
@@ -81,35 +133,268 @@ IC74165_PlatformDeInit(void)
 static void
 IC74165_ClkInhWrite(uint8_t Level)
 {
-  HAL_GPIO_WritePin(IC74165_CLKINH_GPIO, IC74165_CLKINH_PIN, Level);
+  IC74165_CLKINH_GPIO->BSRR = Level ? IC74165_CLKINH_PIN :
+                                      ((uint32_t)IC74165_CLKINH_PIN << 16U);
 }
 #endif
 
 static uint8_t
 IC74165_QhRead(void)
 {
-  return HAL_GPIO_ReadPin(IC74165_QH_GPIO, IC74165_QH_PIN);
+  return (IC74165_QH_GPIO->IDR & IC74165_QH_PIN) ? 1 : 0;
 }
 
 static void
 IC74165_ClkWrite(uint8_t Level)
 {
-  HAL_GPIO_WritePin(IC74165_CLK_GPIO, IC74165_CLK_PIN, Level);
+  IC74165_CLK_GPIO->BSRR = Level ? IC74165_CLK_PIN :
+                                   ((uint32_t)IC74165_CLK_PIN << 16U);
 }
 
 static void
 IC74165_ShLdWrite(uint8_t Level)
 {
-  HAL_GPIO_WritePin(IC74165_SHLD_GPIO, IC74165_SHLD_PIN, Level);
+  IC74165_SHLD_GPIO->BSRR = Level ? IC74165_SHLD_PIN :
+                                    ((uint32_t)IC74165_SHLD_PIN << 16U);
+}
+
+#if (IC74165_DELAY_DWT)
+static inline void
+IC74165_DelayTicks(uint32_t Ticks)
+{
+  uint32_t Start = DWT->CYCCNT;
+  while ((uint32_t)(DWT->CYCCNT - Start) < Ticks)
+  {
+  }
+}
+#else
+static inline void
+IC74165_DelayTicks(uint32_t Ticks)
+{
+  for (; Ticks; --Ticks)
+    __NOP();
+}
+#endif
+
+static inline uint32_t
+IC74165_NsToTicks(uint32_t Ns)
+{
+  return (Ns * IC74165_CyclesPerUs + 1000 * IC74165_DELAY_TICK_CYCLES - 1) /
+         (1000 * IC74165_DELAY_TICK_CYCLES);
 }
 
 static void
 IC74165_DelayUs(uint8_t Delay)
 {
-  for (uint32_t DelayCounter = 0; DelayCounter < 100 * Delay; DelayCounter++)
-    DelayCounter = DelayCounter;
+  IC74165_DelayTicks(IC74165_NsToTicks(1000UL * Delay));
+}
+
+static void
+IC74165_DelayNs(uint16_t Delay)
+{
+  IC74165_DelayTicks(IC74165_NsToTicks(Delay));
 }
 
+static void
+IC74165_DelayInit(void)
+{
+  IC74165_CyclesPerUs = SystemCoreClock / 1000000;
+
+#if (IC74165_DELAY_DWT)
+  uint32_t Start;
+  uint32_t Empty;
+  uint32_t Cycles;
+
+  // CYCCNT is left running; other users of it only see deltas change
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  // Cost of the BSRR store that ShiftBytes uses for each edge, without the
+  // cost of reading CYCCNT. SH/LD idles high, so writing it high again does
+  // not disturb the chain.
+  Start = DWT->CYCCNT;
+  Empty = DWT->CYCCNT - Start;
+  Start = DWT->CYCCNT;
+  IC74165_SHLD_GPIO->BSRR = IC74165_SHLD_PIN;
+  IC74165_SHLD_GPIO->BSRR = IC74165_SHLD_PIN;
+  IC74165_SHLD_GPIO->BSRR = IC74165_SHLD_PIN;
+  IC74165_SHLD_GPIO->BSRR = IC74165_SHLD_PIN;
+  Cycles = DWT->CYCCNT - Start;
+  Cycles = (Cycles > Empty) ? (Cycles - Empty) / 4 : 0;
+  IC74165_EdgeCostNs = (uint16_t)((Cycles * 1000) / IC74165_CyclesPerUs);
+#endif
+}
+
+static void
+IC74165_PlatformInit_Delay(void)
+{
+  IC74165_PlatformInit();
+
+  // Delay is resolved by the core before Init, net of the edge cost;
+  // ClkLow already covers Setup
+  IC74165_ClkHighTicks = IC74165_NsToTicks(IC74165_Handler->Delay.ClkHigh);
+  IC74165_ClkLowTicks = IC74165_NsToTicks(IC74165_Handler->Delay.ClkLow);
+}
+
+static void
+IC74165_ShiftBytes(uint8_t *Data, uint8_t Count)
+{
+  for (; Count; --Count)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      if (IC74165_QH_GPIO->IDR & IC74165_QH_PIN)
+        Buffer |= (1 << j);
+      IC74165_CLK_GPIO->BSRR = IC74165_CLK_PIN;
+      IC74165_DelayTicks(IC74165_ClkHighTicks);
+      IC74165_CLK_GPIO->BSRR = (uint32_t)IC74165_CLK_PIN << 16U;
+      IC74165_DelayTicks(IC74165_ClkLowTicks);
+    }
+
+    if (Data != NULL)
+      *Data++ = Buffer;
+  }
+}
+
+#if (IC74165_SPI_ENABLE)
+#if (IC74165_SPI_DCACHE)
+static void
+IC74165_SPI_CacheClean(uint8_t *Addr, size_t Len)
+{
+  uintptr_t Start = (uintptr_t)Addr & ~(uintptr_t)31;
+  SCB_CleanDCache_by_Addr((uint32_t *)Start,
+                          (int32_t)((uintptr_t)Addr + Len - Start));
+}
+
+static void
+IC74165_SPI_CacheInvalidate(uint8_t *Addr, size_t Len)
+{
+  uintptr_t Start = (uintptr_t)Addr & ~(uintptr_t)31;
+  SCB_InvalidateDCache_by_Addr((uint32_t *)Start,
+                               (int32_t)((uintptr_t)Addr + Len - Start));
+}
+#endif
+
+static HAL_StatusTypeDef
+IC74165_SPI_TransferDMA(uint8_t *Tx, uint8_t *Rx, uint16_t Len)
+{
+#if (IC74165_SPI_DCACHE)
+  // DMA reads TX from memory; RX lines must not be written back over DMA data
+  IC74165_SPI_CacheClean(Tx, Len);
+  if (Rx != Tx)
+    IC74165_SPI_CacheClean(Rx, Len);
+  IC74165_SPI_RxAddr = Rx;
+  IC74165_SPI_RxLen = Len;
+#endif
+  return HAL_SPI_TransmitReceive_DMA(&IC74165_SPI_HANDLE, Tx, Rx, Len);
+}
+
+static void
+IC74165_PlatformInit_SPI(void)
+{
+  memset(IC74165_SPI_TxBuff, 0xFF, sizeof(IC74165_SPI_TxBuff));
+  IC74165_SPI_Busy = 0;
+  IC74165_SPI_Error = 0;
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_SetGPIO_OUT(IC74165_CLKINH_GPIO, IC74165_CLKINH_PIN);
+  IC74165_CLKINH_GPIO->BSRR = IC74165_CLKINH_PIN;
+#endif
+}
+
+static void
+IC74165_PlatformDeInit_SPI(void)
+{
+  HAL_SPI_Abort(&IC74165_SPI_HANDLE);
+  IC74165_SPI_Busy = 0;
+}
+
+static void
+IC74165_SPI_SendReceive(uint8_t *SendData,
+                        uint8_t *ReceiveData,
+                        uint8_t Len)
+{
+  uint8_t Chunk;
+
+  while (Len)
+  {
+    Chunk = (Len > IC74165_SPI_BUFFER_SIZE) ? IC74165_SPI_BUFFER_SIZE : Len;
+
+    IC74165_SPI_Busy = 1;
+    if (IC74165_SPI_TransferDMA(SendData ? SendData : IC74165_SPI_TxBuff,
+                                ReceiveData ? ReceiveData : IC74165_SPI_RxBuff,
+                                Chunk) != HAL_OK)
+    {
+      IC74165_SPI_Busy = 0;
+      IC74165_SPI_Error = 1;
+      return;
+    }
+
+    // Wait for completion signalled by the DMA callbacks
+    while (IC74165_SPI_Busy)
+    {
+    }
+    if (IC74165_SPI_Error)
+      return;
+
+    if (ReceiveData)
+      ReceiveData += Chunk;
+    if (SendData)
+      SendData += Chunk;
+    Len -= Chunk;
+  }
+}
+
+static uint8_t
+IC74165_SPI_StartTransfer(uint8_t *SendData,
+                          uint8_t *ReceiveData,
+                          size_t Len)
+{
+  uint8_t *Tx, *Rx;
+
+  if (IC74165_SPI_Busy || Len == 0 || Len > 0xFFFF)
+    return 0;
+
+  if (SendData == NULL && ReceiveData != NULL)
+  {
+    // Shift in place: DMA reads each TX byte before its RX byte is written
+    memset(ReceiveData, 0xFF, Len);
+    Tx = ReceiveData;
+    Rx = ReceiveData;
+  }
+  else
+  {
+    if ((SendData == NULL || ReceiveData == NULL) && Len > IC74165_SPI_BUFFER_SIZE)
+      return 0;
+    Tx = SendData ? SendData : IC74165_SPI_TxBuff;
+    Rx = ReceiveData ? ReceiveData : IC74165_SPI_RxBuff;
+  }
+
+  IC74165_SPI_Busy = 1;
+  if (IC74165_SPI_TransferDMA(Tx, Rx, (uint16_t)Len) != HAL_OK)
+  {
+    IC74165_SPI_Busy = 0;
+    return 0;
+  }
+
+  return 1;
+}
+
+static uint8_t
+IC74165_SPI_IsComplete(void)
+{
+  return IC74165_SPI_Busy ? 0 : 1;
+}
+
+static uint8_t
+IC74165_SPI_GetError(void)
+{
+  uint8_t Error = IC74165_SPI_Error;
+  IC74165_SPI_Error = 0;
+  return Error;
+}
+#endif
+
 /**
  ==================================================================================
                             ##### Public Functions #####                           
@@ -126,7 +411,7 @@ void
 IC74165_Platform_Init(IC74165_Handler_t *Handler)
 {
   IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_GPIO);
-  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit_Delay);
   IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit);
 #if (IC74165_CLKINH_ENABLE)
   IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
@@ -135,4 +420,101 @@ IC74165_Platform_Init(IC74165_Handler_t *Handler)
   IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(Handler, IC74165_ShLdWrite);
   IC74165_PLATFORM_LINK_GPIO_QHREAD(Handler, IC74165_QhRead);
   IC74165_PLATFORM_LINK_GPIO_DELAYUS(Handler, IC74165_DelayUs);
+  IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(Handler, IC74165_ShiftBytes);
+  IC74165_PLATFORM_LINK_GPIO_DELAYNS(Handler, IC74165_DelayNs);
+  IC74165_Handler = Handler;
+  IC74165_DelayInit();
+#if (IC74165_DELAY_DWT)
+  IC74165_PLATFORM_SET_GPIO_EDGELATENCY(Handler, IC74165_EdgeCostNs);
+#endif
+}
+
+/**
+ * @brief  Get the measured cost of one GPIO edge (one BSRR store, as
+ *         ShiftBytes writes the pins).
+ * @note   It is measured with the DWT cycle counter in IC74165_Platform_Init
+ *         and used as the GPIO edge latency of the handler.
+ * @retval Cost of one edge (ns). 0 if IC74165_DELAY_DWT is 0.
+ */
+uint16_t
+IC74165_Platform_GetEdgeCostNs(void)
+{
+#if (IC74165_DELAY_DWT)
+  return IC74165_EdgeCostNs;
+#else
+  return 0;
+#endif
+}
+
+#if (IC74165_SPI_ENABLE)
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         SPI and DMA.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler)
+{
+  IC74165_PLATFORM_SET_COMMUNICATION(Handler, IC74165_COMMUNICATION_SPI);
+  IC74165_PLATFORM_LINK_INIT(Handler, IC74165_PlatformInit_SPI);
+  IC74165_PLATFORM_LINK_DEINIT(Handler, IC74165_PlatformDeInit_SPI);
+#if (IC74165_CLKINH_ENABLE)
+  IC74165_PLATFORM_LINK_CLKINHWRITE(Handler, IC74165_ClkInhWrite);
+#endif
+  IC74165_PLATFORM_LINK_SPI_SENDRECEIVE(Handler, IC74165_SPI_SendReceive);
+  IC74165_PLATFORM_LINK_SPI_STARTTRANSFER(Handler, IC74165_SPI_StartTransfer);
+  IC74165_PLATFORM_LINK_SPI_ISCOMPLETE(Handler, IC74165_SPI_IsComplete);
+  IC74165_PLATFORM_LINK_SPI_GETERROR(Handler, IC74165_SPI_GetError);
+}
+
+/**
+ * @brief  SPI transfer complete handler. Call it from HAL_SPI_TxRxCpltCallback
+ *         if IC74165_SPI_HAL_CALLBACK is 0.
+ * @param  hspi: SPI handle passed to HAL_SPI_TxRxCpltCallback
+ * @retval None
+ */
+void
+IC74165_Platform_SPI_TxRxCpltCallback(void *hspi)
+{
+  if (hspi == &IC74165_SPI_HANDLE)
+  {
+#if (IC74165_SPI_DCACHE)
+    IC74165_SPI_CacheInvalidate(IC74165_SPI_RxAddr, IC74165_SPI_RxLen);
+#endif
+    IC74165_SPI_Busy = 0;
+  }
 }
+
+/**
+ * @brief  SPI error handler. Call it from HAL_SPI_ErrorCallback if
+ *         IC74165_SPI_HAL_CALLBACK is 0.
+ * @note   The running transfer ends and the scan that used it returns
+ *         IC74165_FAIL.
+ * @param  hspi: SPI handle passed to HAL_SPI_ErrorCallback
+ * @retval None
+ */
+void
+IC74165_Platform_SPI_ErrorCallback(void *hspi)
+{
+  if (hspi == &IC74165_SPI_HANDLE)
+  {
+    IC74165_SPI_Error = 1;
+    IC74165_SPI_Busy = 0;
+  }
+}
+
+#if (IC74165_SPI_HAL_CALLBACK)
+void
+HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  IC74165_Platform_SPI_TxRxCpltCallback(hspi);
+}
+
+void
+HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  IC74165_Platform_SPI_ErrorCallback(hspi);
+}
+#endif
+#endif
@@ -56,6 +56,48 @@ extern "C" {
 #define IC74165_CLKINH_PIN    GPIO_PIN_3
 #define IC74165_CLKINH_ENABLE 0
 
+/**
+ * @brief  Output speed of GPIO pins
+ */
+#define IC74165_GPIO_SPEED    GPIO_SPEED_FREQ_VERY_HIGH
+
+/**
+ * @brief  Delay options
+ *         - IC74165_DELAY_DWT: 1 to use the DWT cycle counter for delays and
+ *           for the CLK phases of the timing profile (Cortex-M3 and above,
+ *           not Cortex-M0/M0+), 0 to use a software loop calibrated from
+ *           SystemCoreClock (Cortex-M0/M0+)
+ *         - IC74165_DELAY_LOOP_CYCLES: Minimum CPU cycles of one iteration of
+ *           the software loop (NOP, decrement and branch). Delays are rounded
+ *           up with it, so they are never shorter than requested.
+ */
+#define IC74165_DELAY_DWT          0
+#define IC74165_DELAY_LOOP_CYCLES  3
+
+/**
+ * @brief  SPI options
+ *         - IC74165_SPI_ENABLE: 1 to build the SPI and DMA mode
+ *           (IC74165_Platform_Init_SPI). It needs HAL_SPI_MODULE_ENABLED and
+ *           the SPI handle below.
+ *         - IC74165_SPI_HANDLE: SPI handle configured by the user (mode 1,
+ *           8-bit, with TX and RX DMA channels)
+ *         - IC74165_SPI_BUFFER_SIZE: Size of internal dummy TX/RX buffers
+ *         - IC74165_SPI_HAL_CALLBACK: 1 to define HAL_SPI_TxRxCpltCallback and
+ *           HAL_SPI_ErrorCallback in the port. Set it to 0 if the application
+ *           defines them and call IC74165_Platform_SPI_TxRxCpltCallback and
+ *           IC74165_Platform_SPI_ErrorCallback from there.
+ * @note   In SPI mode the MOSI, MISO and SCK pins must be connected to SH/LD,
+ *         Qh and CLK pins of 74165 and CLK-INH is driven as chip select.
+ * @note   On cores with a data cache (Cortex-M7) the port cleans and
+ *         invalidates the buffers around each DMA transfer. Buffers passed to
+ *         the driver must then be aligned to and sized in 32-byte cache lines,
+ *         or be placed in non-cacheable memory.
+ */
+#define IC74165_SPI_ENABLE        0
+#define IC74165_SPI_HANDLE        hspi1
+#define IC74165_SPI_BUFFER_SIZE   32
+#define IC74165_SPI_HAL_CALLBACK  0
+
 
 
 /**
@@ -74,6 +116,51 @@ void
 IC74165_Platform_Init(IC74165_Handler_t *Handler);
 
 
+/**
+ * @brief  Get the measured cost of one GPIO edge (one BSRR store, as
+ *         ShiftBytes writes the pins).
+ * @note   It is measured with the DWT cycle counter in IC74165_Platform_Init
+ *         and used as the GPIO edge latency of the handler.
+ * @retval Cost of one edge (ns). 0 if IC74165_DELAY_DWT is 0.
+ */
+uint16_t
+IC74165_Platform_GetEdgeCostNs(void);
+
+
+#if (IC74165_SPI_ENABLE)
+/**
+ * @brief  Initialize platform dependent layer to communicate with 74165 using
+ *         SPI and DMA.
+ * @param  Handler: Pointer to handler
+ * @retval None
+ */
+void
+IC74165_Platform_Init_SPI(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  SPI transfer complete handler. Call it from HAL_SPI_TxRxCpltCallback
+ *         if IC74165_SPI_HAL_CALLBACK is 0.
+ * @param  hspi: SPI handle passed to HAL_SPI_TxRxCpltCallback
+ * @retval None
+ */
+void
+IC74165_Platform_SPI_TxRxCpltCallback(void *hspi);
+
+
+/**
+ * @brief  SPI error handler. Call it from HAL_SPI_ErrorCallback if
+ *         IC74165_SPI_HAL_CALLBACK is 0.
+ * @note   The running transfer ends and the scan that used it returns
+ *         IC74165_FAIL.
+ * @param  hspi: SPI handle passed to HAL_SPI_ErrorCallback
+ * @retval None
+ */
+void
+IC74165_Platform_SPI_ErrorCallback(void *hspi);
+#endif
+
+
 
 #ifdef __cplusplus
 }
@@ -34,48 +34,236 @@
 #include <string.h>
 
 
+/* Private Macros ---------------------------------------------------------------*/
+/**
+ * @brief  States of asynchronous read
+ */
+#define IC74165_ASYNC_IDLE    0
+#define IC74165_ASYNC_LOAD    1
+#define IC74165_ASYNC_SHIFT   2
+
+
+
+/* Private Constants ------------------------------------------------------------*/
+/**
+ * @brief  Minimum timing of each chip family (ns), indexed by IC74165_Family_t
+ */
+static const IC74165_Timing_t IC74165_FamilyTiming[] = IC74165_FAMILY_TIMING;
+
+
+
 /**
  ==================================================================================
                           ##### Private Functions #####                            
  ==================================================================================
  */
 
+static inline void
+IC74165_Delay(IC74165_Handler_t *Handler, uint16_t Delay)
+{
+  if (Handler->Platform.GPIO.DelayNs)
+  {
+    if (Delay)
+      Handler->Platform.GPIO.DelayNs(Delay);
+  }
+  else
+  {
+    Handler->Platform.GPIO.DelayUs(1);
+  }
+}
+
+static uint16_t
+IC74165_TimingSelect(uint16_t Value, uint16_t Min, uint16_t Latency,
+                     IC74165_Result_t *Result)
+{
+  if (Value == 0)
+    Value = Min;
+  else if (Value < Min)
+    *Result = IC74165_FAIL;
+
+  return (Value > Latency) ? (Value - Latency) : 0;
+}
+
+static IC74165_Result_t
+IC74165_TimingInit(IC74165_Handler_t *Handler)
+{
+  IC74165_Result_t Result = IC74165_OK;
+  const IC74165_Timing_t *Min;
+  uint16_t Latency = Handler->Platform.GPIO.EdgeLatency;
+  uint16_t ClkLow;
+
+  if ((uint32_t)Handler->Family >=
+      sizeof(IC74165_FamilyTiming) / sizeof(IC74165_FamilyTiming[0]))
+    return IC74165_FAIL;
+  Min = &IC74165_FamilyTiming[Handler->Family];
+
+  Handler->Delay.LoadPulse =
+      IC74165_TimingSelect(Handler->Timing.LoadPulse, Min->LoadPulse, Latency, &Result);
+  Handler->Delay.ClkHigh =
+      IC74165_TimingSelect(Handler->Timing.ClkHigh, Min->ClkHigh, Latency, &Result);
+  Handler->Delay.Setup =
+      IC74165_TimingSelect(Handler->Timing.Setup, Min->Setup, Latency, &Result);
+  ClkLow =
+      IC74165_TimingSelect(Handler->Timing.ClkLow, Min->ClkLow, Latency, &Result);
+
+  // Qh is sampled right after the CLK low phase
+  Handler->Delay.ClkLow =
+      (ClkLow > Handler->Delay.Setup) ? ClkLow : Handler->Delay.Setup;
+
+  return Result;
+}
+
+/**
+ * @brief  SPI transfer with a wide length. Ports that do not link
+ *         SendReceiveWide get the transfer split into 255-byte SendReceive
+ *         calls; CS (CLK-INH) is driven by the core around the whole transfer.
+ */
+static void
+IC74165_SendReceive(IC74165_Handler_t *Handler, uint8_t *SendData,
+                    uint8_t *ReceiveData, size_t Len)
+{
+  if (Handler->Platform.SPI.SendReceiveWide)
+  {
+    Handler->Platform.SPI.SendReceiveWide(SendData, ReceiveData, Len);
+    return;
+  }
+
+  while (Len)
+  {
+    uint8_t Chunk = (Len > 255) ? 255 : (uint8_t)Len;
+    Handler->Platform.SPI.SendReceive(SendData, ReceiveData, Chunk);
+    if (SendData != NULL)
+      SendData += Chunk;
+    if (ReceiveData != NULL)
+      ReceiveData += Chunk;
+    Len -= Chunk;
+  }
+}
+
+#if (IC74165_CONFIG_STATS)
+static inline void
+IC74165_StatsBegin(IC74165_Handler_t *Handler)
+{
+  IC74165_Stats_t *Stats = &Handler->Stats;
+  uint32_t Now;
+
+  if (Handler->Platform.GetTick == NULL)
+    return;
+
+  Now = Handler->Platform.GetTick();
+  if (Stats->Scans)
+  {
+    uint32_t Interval = Now - Stats->LastStart;
+    if (Interval < Stats->MinInterval)
+      Stats->MinInterval = Interval;
+    if (Interval > Stats->MaxInterval)
+      Stats->MaxInterval = Interval;
+  }
+  Stats->LastStart = Now;
+}
+
+static inline void
+IC74165_StatsEnd(IC74165_Handler_t *Handler)
+{
+  IC74165_Stats_t *Stats = &Handler->Stats;
+  uint32_t Time;
+  uint8_t Bucket = 0;
+
+  Stats->Scans++;
+  if (Handler->Platform.GetTick == NULL)
+    return;
+
+  Time = Handler->Platform.GetTick() - Stats->LastStart;
+  if (Time < Stats->MinTime)
+    Stats->MinTime = Time;
+  if (Time > Stats->MaxTime)
+    Stats->MaxTime = Time;
+  Stats->TotalTime += Time;
+
+  // Bucket is the bit length of Time
+  for (uint32_t t = Time; t && Bucket < IC74165_STATS_BUCKETS - 1; t >>= 1)
+    Bucket++;
+  Stats->Histogram[Bucket]++;
+}
+
+static inline void
+IC74165_StatsShift(IC74165_Handler_t *Handler, uint16_t Count)
+{
+  Handler->Stats.Bytes += Count;
+  Handler->Stats.Bits += 8 * (uint32_t)Count;
+}
+#else
+#define IC74165_StatsBegin(HANDLER)         ((void)0)
+#define IC74165_StatsEnd(HANDLER)           ((void)0)
+#define IC74165_StatsShift(HANDLER, COUNT)  ((void)0)
+#endif
+
+static inline uint8_t
+IC74165_BusAcquire(IC74165_Handler_t *Handler, uint8_t Block)
+{
+  if (Handler->Platform.BusAcquire == NULL)
+    return 1;
+  return Handler->Platform.BusAcquire(Block);
+}
+
+static inline void
+IC74165_BusRelease(IC74165_Handler_t *Handler)
+{
+  if (Handler->Platform.BusRelease)
+    Handler->Platform.BusRelease();
+}
+
 static inline IC74165_Result_t
 IC74165_Load(IC74165_Handler_t *Handler)
 {
   if (Handler->Platform.Communication == IC74165_COMMUNICATION_GPIO)
   {
     Handler->Platform.GPIO.ShLdWrite(0);
-    Handler->Platform.GPIO.DelayUs(1);
+    IC74165_Delay(Handler, Handler->Delay.LoadPulse);
     Handler->Platform.GPIO.ShLdWrite(1);
-    Handler->Platform.GPIO.DelayUs(1);
+    IC74165_Delay(Handler, Handler->Delay.Setup);
   }
   else if (Handler->Platform.Communication == IC74165_COMMUNICATION_SPI)
   {
     uint8_t Buffer = 0;
-    Handler->Platform.SPI.SendReceive(&Buffer, &Buffer, 1);
+    IC74165_SendReceive(Handler, &Buffer, NULL, 1);
   }
   return IC74165_OK;
 }
 
 static IC74165_Result_t
-IC74165_ShiftIn(IC74165_Handler_t *Handler, uint8_t *Data, uint8_t Count)
+IC74165_Shift(IC74165_Handler_t *Handler, uint8_t *Data, uint16_t Count)
 {
-  if (Handler->Platform.ClkInhWrite)
-    Handler->Platform.ClkInhWrite(0);
+  if (Count == 0)
+    return IC74165_OK;
 
-  if (Handler->Platform.Communication == IC74165_COMMUNICATION_GPIO)
+  IC74165_StatsShift(Handler, Count);
+
+  if (Handler->Platform.Communication == IC74165_COMMUNICATION_GPIO &&
+      Handler->Platform.GPIO.ShiftBytes)
+  {
+    // ShiftBytes keeps its 8-bit count; CLK-INH stays low between the calls
+    while (Count)
+    {
+      uint8_t Len = (Count > 255) ? 255 : (uint8_t)Count;
+      Handler->Platform.GPIO.ShiftBytes(Data, Len);
+      if (Data != NULL)
+        Data += Len;
+      Count -= Len;
+    }
+  }
+  else if (Handler->Platform.Communication == IC74165_COMMUNICATION_GPIO)
   {
-    for (uint8_t i = 0; i < Count; i++)
+    for (uint16_t i = 0; i < Count; i++)
     {
       uint8_t Buffer = 0;
       for (int8_t j = 7; j >= 0; j--)
       {
         Buffer |= (Handler->Platform.GPIO.QhRead() << j);
         Handler->Platform.GPIO.ClkWrite(1);
-        Handler->Platform.GPIO.DelayUs(1);
+        IC74165_Delay(Handler, Handler->Delay.ClkHigh);
         Handler->Platform.GPIO.ClkWrite(0);
-        Handler->Platform.GPIO.DelayUs(1);
+        IC74165_Delay(Handler, Handler->Delay.ClkLow);
       }
 
       if (Data != NULL)
@@ -84,16 +272,280 @@ IC74165_ShiftIn(IC74165_Handler_t *Handler, uint8_t *Data, uint8_t Count)
   }
   else if (Handler->Platform.Communication == IC74165_COMMUNICATION_SPI)
   {
-    if (Data != NULL)
-      memset(Data, 0xFF, Count);
-    Handler->Platform.SPI.SendReceive(Data, Data, Count);
+    // SH/LD (MOSI) stays high; skipped bytes are received into nothing
+    IC74165_SendReceive(Handler, NULL, Data, Count);
+
+    // The error also covers the load, which is always followed by a shift
+    if (Handler->Platform.SPI.GetError && Handler->Platform.SPI.GetError())
+      return IC74165_FAIL;
+  }
+
+  return IC74165_OK;
+}
+
+static IC74165_Result_t
+IC74165_ShiftIn(IC74165_Handler_t *Handler, uint8_t *Data,
+                uint16_t Skip, uint16_t Count, uint8_t *Tail)
+{
+  IC74165_Result_t Result;
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(0);
+
+  Result = IC74165_Shift(Handler, NULL, Skip);
+  if (Result == IC74165_OK)
+    Result = IC74165_Shift(Handler, Data, Count);
+  if (Result == IC74165_OK && Tail != NULL)
+    Result = IC74165_Shift(Handler, Tail, 1);
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(1);
+
+  return Result;
+}
+
+static IC74165_Result_t
+IC74165_ShiftInStream(IC74165_Handler_t *Handler, uint8_t *Buffer,
+                      uint16_t ChunkLen, IC74165_ChunkCallback_t Callback,
+                      void *Ctx)
+{
+  IC74165_Result_t Result = IC74165_OK;
+  uint16_t Pos = 0;
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(0);
+
+  // No clock edge happens while the callback runs, so the chain waits for it
+  while (Pos < Handler->ChainLen)
+  {
+    uint16_t Len = Handler->ChainLen - Pos;
+    if (Len > ChunkLen)
+      Len = ChunkLen;
+
+    Result = IC74165_Shift(Handler, Buffer, Len);
+    if (Result != IC74165_OK)
+      break;
+
+    Callback(Buffer, Pos, Len, Ctx);
+    Pos += Len;
+  }
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(1);
+
+  return Result;
+}
+
+static IC74165_Result_t
+IC74165_ShiftInPlan(IC74165_Handler_t *Handler, const IC74165_Plan_t *Plan,
+                    uint8_t *Out)
+{
+  IC74165_Result_t Result = IC74165_OK;
+  uint8_t Run[8];
+  uint32_t Bit = 0;
+  uint16_t i = 0;
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(0);
+
+  // Clocking stops after the last chip of the plan
+  while (i < Plan->EntryCount)
+  {
+    const IC74165_PlanEntry_t *Entry = &Plan->Entries[i];
+    uint8_t Len = 1;
+
+    // Adjacent chips are shifted in one call, gaps are shifted without storing
+    while (i + Len < Plan->EntryCount && Len < sizeof(Run) &&
+           Entry[Len].Skip == 0)
+      Len++;
+
+    Result = IC74165_Shift(Handler, NULL, Entry->Skip);
+    if (Result == IC74165_OK)
+      Result = IC74165_Shift(Handler, Run, Len);
+    if (Result != IC74165_OK)
+      break;
+
+    for (uint8_t j = 0; j < Len; j++)
+    {
+      uint8_t Mask = Entry[j].Mask;
+      while (Mask)
+      {
+        if (Run[j] & Mask & (uint8_t)-Mask)
+          Out[Bit >> 3] |= (uint8_t)(1U << (Bit & 7));
+        Bit++;
+        Mask &= Mask - 1;
+      }
+    }
+
+    i += Len;
   }
 
   if (Handler->Platform.ClkInhWrite)
     Handler->Platform.ClkInhWrite(1);
 
+  return Result;
+}
+
+#if (IC74165_CONFIG_INTEGRITY)
+/**
+ * @brief  Check the last chip and the byte shifted in from its SER.
+ */
+static inline IC74165_Result_t
+IC74165_IntegrityCheck(IC74165_Handler_t *Handler, uint8_t Last, uint8_t Tail)
+{
+  if (Tail != Handler->Integrity.Fill)
+    return IC74165_CORRUPT;
+  if ((Last & Handler->Integrity.MarkerMask) != Handler->Integrity.Marker)
+    return IC74165_CORRUPT;
   return IC74165_OK;
 }
+#endif
+
+/**
+ * @brief  Load and shift the chain under one bus acquisition.
+ */
+static IC74165_Result_t
+IC74165_Scan(IC74165_Handler_t *Handler, uint8_t *Data,
+             uint16_t Skip, uint16_t Count, uint8_t Block)
+{
+  IC74165_Result_t Result;
+  uint8_t *Tail = NULL;
+#if (IC74165_CONFIG_INTEGRITY)
+  uint8_t Fill = 0;
+
+  // A scan that reaches the last chip also clocks one byte of SER fill
+  if ((uint32_t)Skip + Count == Handler->ChainLen)
+    Tail = &Fill;
+#endif
+
+  // The chain belongs to the asynchronous read until it is complete
+  if (Handler->Async.State != IC74165_ASYNC_IDLE)
+    return IC74165_BUSY;
+
+  if (!IC74165_BusAcquire(Handler, Block))
+    return Block ? IC74165_FAIL : IC74165_BUSY;
+
+  IC74165_StatsBegin(Handler);
+  IC74165_Load(Handler);
+
+  Result = IC74165_ShiftIn(Handler, Data, Skip, Count, Tail);
+  IC74165_StatsEnd(Handler);
+
+  IC74165_BusRelease(Handler);
+
+#if (IC74165_CONFIG_INTEGRITY)
+  if (Result == IC74165_OK && Tail != NULL)
+    Result = IC74165_IntegrityCheck(Handler, Data[Count - 1], Fill);
+#endif
+
+  return Result;
+}
+
+static IC74165_Result_t
+IC74165_ScanAll(IC74165_Handler_t *Handler, uint8_t *Data, uint8_t Block)
+{
+#if (IC74165_CONFIG_CACHE)
+  // A full scan is a fresh snapshot; the time is taken before the load
+  if (Handler->Cache.Buffer)
+  {
+    uint32_t Now = Handler->Platform.GetTick();
+    IC74165_Result_t Result;
+
+    Result = IC74165_Scan(Handler, Data, 0, Handler->ChainLen, Block);
+    if (Result != IC74165_OK)
+      return Result;
+
+    memcpy(Handler->Cache.Buffer, Data, Handler->ChainLen);
+    Handler->Cache.Stamp = Now;
+    Handler->Cache.Valid = 1;
+    return IC74165_OK;
+  }
+#endif
+
+  return IC74165_Scan(Handler, Data, 0, Handler->ChainLen, Block);
+}
+
+static IC74165_Result_t
+IC74165_AsyncFinish(IC74165_Handler_t *Handler, IC74165_Result_t Result)
+{
+  if (Handler->Async.State == IC74165_ASYNC_SHIFT && Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(1);
+
+  IC74165_StatsEnd(Handler);
+  IC74165_BusRelease(Handler);
+  Handler->Async.State = IC74165_ASYNC_IDLE;
+
+  if (Handler->Async.Callback)
+    Handler->Async.Callback(Result, Handler->Async.Data, Handler->Async.Ctx);
+
+  return Result;
+}
+
+
+
+/**
+ * @brief  Transpose an 8x8 bit matrix. Bit (8 * i + j) moves to bit (8 * j + i).
+ */
+static inline uint64_t
+IC74165_Transpose8(uint64_t x)
+{
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+
+  return x;
+}
+
+static void
+IC74165_Multi_ShiftIn(IC74165_Multi_t *Multi, uint8_t *Data)
+{
+  IC74165_Handler_t *Handler = &Multi->Handler;
+  uint16_t ChainLen = Handler->ChainLen;
+  uint8_t Lanes = (Multi->ChainCount + 7) / 8;
+  uint32_t Samples[8];
+
+  IC74165_StatsShift(Handler, ChainLen);
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(0);
+
+  for (uint16_t i = 0; i < ChainLen; i++)
+  {
+    // One port read per clock captures the current bit of every chain
+    for (uint8_t j = 0; j < 8; j++)
+    {
+      Samples[j] = Multi->PortRead();
+      Handler->Platform.GPIO.ClkWrite(1);
+      IC74165_Delay(Handler, Handler->Delay.ClkHigh);
+      Handler->Platform.GPIO.ClkWrite(0);
+      IC74165_Delay(Handler, Handler->Delay.ClkLow);
+    }
+
+    // Each 8-chain lane of the samples is an 8x8 bit matrix: row j holds bit
+    // (7 - j) of 8 chains. Transposed, row k is the byte of chain k.
+    for (uint8_t Lane = 0; Lane < Lanes; Lane++)
+    {
+      uint64_t Matrix = 0;
+      uint8_t Chain = Lane * 8;
+
+      for (uint8_t j = 0; j < 8; j++)
+        Matrix |= (uint64_t)((Samples[j] >> Chain) & 0xFF) << (8 * (7 - j));
+
+      Matrix = IC74165_Transpose8(Matrix);
+
+      for (uint8_t k = 0; k < 8 && Chain < Multi->ChainCount; k++, Chain++)
+        Data[(size_t)Chain * ChainLen + i] = (uint8_t)(Matrix >> (8 * k));
+    }
+  }
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(1);
+}
 
 
 
@@ -107,27 +559,59 @@ IC74165_ShiftIn(IC74165_Handler_t *Handler, uint8_t *Data, uint8_t Count)
  * @brief  Initialization function.
  * @param  Handler: Pointer to handler
  * @param  ChainLen: Number of chained 74165
+ * @note   The timing profile of the handler is validated against the minimum
+ *         values of Handler->Family.
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
  */
 IC74165_Result_t
 IC74165_Init(IC74165_Handler_t *Handler, uint8_t ChainLen)
+{
+  return IC74165_InitWide(Handler, ChainLen);
+}
+
+
+/**
+ * @brief  Initialization function for chains longer than 255 devices.
+ * @param  Handler: Pointer to handler
+ * @param  ChainLen: Number of chained 74165
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_InitWide(IC74165_Handler_t *Handler, uint16_t ChainLen)
 {
   if (Handler->Platform.Communication == IC74165_COMMUNICATION_GPIO)
   {
     if (Handler->Platform.GPIO.ClkWrite == NULL ||
         Handler->Platform.GPIO.ShLdWrite == NULL ||
         Handler->Platform.GPIO.QhRead == NULL ||
-        Handler->Platform.GPIO.DelayUs == NULL)
+        (Handler->Platform.GPIO.DelayUs == NULL &&
+         Handler->Platform.GPIO.DelayNs == NULL))
+      return IC74165_FAIL;
+
+    if (IC74165_TimingInit(Handler) != IC74165_OK)
       return IC74165_FAIL;
   }
   else if (Handler->Platform.Communication == IC74165_COMMUNICATION_SPI)
   {
-    if (Handler->Platform.SPI.SendReceive == NULL)
+    if (Handler->Platform.SPI.SendReceive == NULL &&
+        Handler->Platform.SPI.SendReceiveWide == NULL)
       return IC74165_FAIL;
   }
 
+#if (IC74165_CONFIG_INTEGRITY)
+  // The marker must differ from the SER fill to tell the last chip apart
+  if ((Handler->Integrity.Fill != 0x00 && Handler->Integrity.Fill != 0xFF) ||
+      (Handler->Integrity.Marker & ~Handler->Integrity.MarkerMask) ||
+      (Handler->Integrity.MarkerMask &&
+       !((Handler->Integrity.Marker ^ Handler->Integrity.Fill) &
+         Handler->Integrity.MarkerMask)))
+    return IC74165_FAIL;
+#endif
+
   if (Handler->Platform.Init)
     Handler->Platform.Init();
 
@@ -135,6 +619,13 @@ IC74165_Init(IC74165_Handler_t *Handler, uint8_t ChainLen)
     ChainLen = 1;
 
   Handler->ChainLen = ChainLen;
+  Handler->Async.State = IC74165_ASYNC_IDLE;
+#if (IC74165_CONFIG_STATS)
+  IC74165_Stats_Reset(Handler);
+#endif
+#if (IC74165_CONFIG_CACHE)
+  memset(&Handler->Cache, 0, sizeof(Handler->Cache));
+#endif
 
   return IC74165_OK;
 }
@@ -160,34 +651,58 @@ IC74165_DeInit(IC74165_Handler_t *Handler)
 /**
  * @brief  Read chain.
  * @param  Handler: Pointer to handler
- * @note   In case of using SPI, this function will not work and you should use
- *         IC74165_ReadAll() function.
+ * @note   Only the first Pos+Count bytes of the chain are shifted.
  * @param  Data: Pointer to a buffer to store data
  * @param  Pos: Start position in chain
  * @param  Count: Number of bytes to read from chain
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
  */
 IC74165_Result_t
 IC74165_Read(IC74165_Handler_t *Handler, uint8_t *Data,
              uint8_t Pos, uint8_t Count)
 {
-  if (Handler->ChainLen == 0)
-    return IC74165_FAIL;
-
-  if (Count + Pos > Handler->ChainLen)
-    Count = Handler->ChainLen - Pos;
+  return IC74165_ReadWide(Handler, Data, Pos, Count);
+}
 
-  IC74165_Load(Handler);
 
-  if (IC74165_ShiftIn(Handler, NULL, Pos) != IC74165_OK)
+/**
+ * @brief  Read chain with wide position and count.
+ * @param  Handler: Pointer to handler
+ * @note   Only the first Pos+Count bytes of the chain are shifted.
+ * @param  Data: Pointer to a buffer to store data
+ * @param  Pos: Start position in chain
+ * @param  Count: Number of bytes to read from chain
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadWide(IC74165_Handler_t *Handler, uint8_t *Data,
+                 uint16_t Pos, uint16_t Count)
+{
+  if (Handler->ChainLen == 0)
     return IC74165_FAIL;
 
-  if (IC74165_ShiftIn(Handler, Data, Count) != IC74165_OK)
+  if (Pos >= Handler->ChainLen)
     return IC74165_FAIL;
 
-  return IC74165_OK;
+  if ((uint32_t)Count + Pos > Handler->ChainLen)
+    Count = Handler->ChainLen - Pos;
+
+#if (IC74165_CONFIG_CACHE)
+  if (Handler->Cache.Buffer)
+    return IC74165_ReadCached(Handler, Data, Pos, Count,
+                              IC74165_CACHE_MAXAGE_HANDLER);
+#endif
+
+  // Only the first Pos+Count bytes of the chain are shifted
+  return IC74165_Scan(Handler, Data, Pos, Count, 1);
 }
 
 
@@ -198,6 +713,8 @@ IC74165_Read(IC74165_Handler_t *Handler, uint8_t *Data,
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
  */
 IC74165_Result_t
 IC74165_ReadAll(IC74165_Handler_t *Handler, uint8_t *Data)
@@ -205,29 +722,629 @@ IC74165_ReadAll(IC74165_Handler_t *Handler, uint8_t *Data)
   if (Handler->ChainLen == 0)
     return IC74165_FAIL;
 
-  IC74165_Load(Handler);
+  return IC74165_ScanAll(Handler, Data, 1);
+}
 
-  if (IC74165_ShiftIn(Handler, Data, Handler->ChainLen) != IC74165_OK)
+
+/**
+ * @brief  Read all chained devices if the bus is free.
+ * @note   It returns immediately if BusAcquire reports that the bus is busy.
+ * @param  Handler: Pointer to handler
+ * @param  Data: Pointer to a buffer to store data
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: Bus is busy or an asynchronous read is in
+ *                         progress. Nothing is read.
+ */
+IC74165_Result_t
+IC74165_TryReadAll(IC74165_Handler_t *Handler, uint8_t *Data)
+{
+  if (Handler->ChainLen == 0)
     return IC74165_FAIL;
 
-  return IC74165_OK;
+  return IC74165_ScanAll(Handler, Data, 0);
 }
 
 
 /**
- * @brief  Read a shift register in the chain.
- * @note   In case of using SPI, this function will not work and you should use
- *         IC74165_ReadAll() function.
+ * @brief  Start reading all chained devices without waiting for it.
+ * @note   It needs StartTransfer and IsComplete of the SPI platform layer.
+ *         Otherwise the chain is read before it returns and Callback is
+ *         called from it.
+ * @note   Call IC74165_Poll until it returns IC74165_OK. Callback is called
+ *         from IC74165_Poll when the read is complete. Data must stay valid
+ *         until then.
  * @param  Handler: Pointer to handler
- * @param  Data: Pointer to a buffer to store data
- * @param  Pos: The position in the chain
+ * @param  Data: Pointer to a buffer of ChainLen bytes
+ * @param  Callback: Function to call when the read is complete (optional)
+ * @param  Ctx: User context
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_BUSY: A read is in progress or the bus is busy.
  */
 IC74165_Result_t
-IC74165_ReadOne(IC74165_Handler_t *Handler, uint8_t *Data,
-                uint8_t Pos)
+IC74165_ReadAllAsync(IC74165_Handler_t *Handler, uint8_t *Data,
+                     IC74165_AsyncCallback_t Callback, void *Ctx)
 {
-  return IC74165_Read(Handler, Data, Pos, 1);
+  IC74165_Result_t Result;
+
+  if (Handler->ChainLen == 0 || Data == NULL)
+    return IC74165_FAIL;
+
+  if (Handler->Async.State != IC74165_ASYNC_IDLE)
+    return IC74165_BUSY;
+
+  if (Handler->Platform.Communication != IC74165_COMMUNICATION_SPI ||
+      Handler->Platform.SPI.StartTransfer == NULL ||
+      Handler->Platform.SPI.IsComplete == NULL)
+  {
+    Result = IC74165_ReadAll(Handler, Data);
+    if (Callback)
+      Callback(Result, Data, Ctx);
+    return Result;
+  }
+
+  if (!IC74165_BusAcquire(Handler, 0))
+    return IC74165_BUSY;
+
+  Handler->Async.Data = Data;
+  Handler->Async.Callback = Callback;
+  Handler->Async.Ctx = Ctx;
+  Handler->Async.LoadByte = 0;
+
+  IC74165_StatsBegin(Handler);
+
+  // Parallel load; the shift is started by IC74165_Poll when it is complete
+  if (!Handler->Platform.SPI.StartTransfer(&Handler->Async.LoadByte, NULL, 1))
+  {
+    IC74165_StatsEnd(Handler);
+    IC74165_BusRelease(Handler);
+    return IC74165_FAIL;
+  }
+  Handler->Async.State = IC74165_ASYNC_LOAD;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Advance the asynchronous read.
+ * @param  Handler: Pointer to handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: No read is in progress (the last one is complete).
+ *         - IC74165_FAIL: The read failed. Callback is called with it.
+ *         - IC74165_BUSY: The read is in progress.
+ */
+IC74165_Result_t
+IC74165_Poll(IC74165_Handler_t *Handler)
+{
+  if (Handler->Async.State == IC74165_ASYNC_IDLE)
+    return IC74165_OK;
+
+  if (!Handler->Platform.SPI.IsComplete())
+    return IC74165_BUSY;
+
+  // A failed transfer fails the read, like IC74165_Shift
+  if (Handler->Platform.SPI.GetError && Handler->Platform.SPI.GetError())
+    return IC74165_AsyncFinish(Handler, IC74165_FAIL);
+
+  if (Handler->Async.State == IC74165_ASYNC_LOAD)
+  {
+    if (Handler->Platform.ClkInhWrite)
+      Handler->Platform.ClkInhWrite(0);
+
+    Handler->Async.State = IC74165_ASYNC_SHIFT;
+    IC74165_StatsShift(Handler, Handler->ChainLen);
+    if (!Handler->Platform.SPI.StartTransfer(NULL, Handler->Async.Data,
+                                             Handler->ChainLen))
+      return IC74165_AsyncFinish(Handler, IC74165_FAIL);
+
+    return IC74165_BUSY;
+  }
+
+  return IC74165_AsyncFinish(Handler, IC74165_OK);
+}
+
+
+/**
+ * @brief  Check if an asynchronous read is in progress.
+ * @param  Handler: Pointer to handler
+ * @retval 
+ *         - 0: No read is in progress
+ *         - 1: A read is in progress
+ */
+uint8_t
+IC74165_IsBusy(IC74165_Handler_t *Handler)
+{
+  return (Handler->Async.State != IC74165_ASYNC_IDLE) ? 1 : 0;
+}
+
+
+/**
+ * @brief  Read a shift register in the chain.
+ * @note   Only the first Pos+1 bytes of the chain are shifted.
+ * @param  Handler: Pointer to handler
+ * @param  Data: Pointer to a buffer to store data
+ * @param  Pos: The position in the chain
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadOne(IC74165_Handler_t *Handler, uint8_t *Data,
+                uint8_t Pos)
+{
+  return IC74165_Read(Handler, Data, Pos, 1);
+}
+
+
+/**
+ * @brief  Read all chained devices in chunks.
+ * @note   The chain is loaded once and shifted ChunkLen bytes at a time. After
+ *         each chunk Callback is called while CLK is idle, so the chain keeps
+ *         its state and the processing time does not corrupt the data.
+ * @param  Handler: Pointer to handler
+ * @param  Buffer: Pointer to a buffer of ChunkLen bytes
+ * @param  ChunkLen: Number of bytes passed to each Callback call
+ * @param  Callback: Function to call for each chunk
+ * @param  Ctx: User context
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadStream(IC74165_Handler_t *Handler, uint8_t *Buffer, uint16_t ChunkLen,
+                   IC74165_ChunkCallback_t Callback, void *Ctx)
+{
+  IC74165_Result_t Result;
+
+  if (Handler->ChainLen == 0 || Buffer == NULL ||
+      ChunkLen == 0 || Callback == NULL)
+    return IC74165_FAIL;
+
+  if (Handler->Async.State != IC74165_ASYNC_IDLE)
+    return IC74165_BUSY;
+
+  if (!IC74165_BusAcquire(Handler, 1))
+    return IC74165_FAIL;
+
+  IC74165_StatsBegin(Handler);
+  IC74165_Load(Handler);
+
+  Result = IC74165_ShiftInStream(Handler, Buffer, ChunkLen, Callback, Ctx);
+  IC74165_StatsEnd(Handler);
+
+  IC74165_BusRelease(Handler);
+
+  if (Result != IC74165_OK)
+    return IC74165_FAIL;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Build a read plan from a list of (chip, mask) entries.
+ * @note   The plan does not copy the entries. On success they are sorted by
+ *         chip in place and entries of the same chip are merged into the first
+ *         EntryCount elements, so the array belongs to the plan and must stay
+ *         valid and unmodified while the plan is in use. On failure the array
+ *         is not modified.
+ * @param  Handler: Pointer to initialized handler
+ * @param  Plan: Pointer to plan
+ * @param  Entries: Pointer to entries. Skip fields are set by this function.
+ * @param  Count: Number of entries
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful (empty list, chip out
+ *                         of chain or zero mask).
+ */
+IC74165_Result_t
+IC74165_Plan_Init(IC74165_Handler_t *Handler, IC74165_Plan_t *Plan,
+                  IC74165_PlanEntry_t *Entries, uint16_t Count)
+{
+  uint16_t Len = 0;
+  uint32_t Bits = 0;
+
+  if (Handler->ChainLen == 0 || Entries == NULL || Count == 0)
+    return IC74165_FAIL;
+
+  // Validate everything first, so a bad list leaves the array as it was
+  for (uint16_t i = 0; i < Count; i++)
+    if (Entries[i].Chip >= Handler->ChainLen || Entries[i].Mask == 0)
+      return IC74165_FAIL;
+
+  // Insertion sort by chip; plans are short and built once
+  for (uint16_t i = 1; i < Count; i++)
+  {
+    IC74165_PlanEntry_t Entry = Entries[i];
+    uint16_t j = i;
+    for (; j > 0 && Entries[j - 1].Chip > Entry.Chip; j--)
+      Entries[j] = Entries[j - 1];
+    Entries[j] = Entry;
+  }
+
+  for (uint16_t i = 0; i < Count; i++)
+  {
+    if (Len && Entries[Len - 1].Chip == Entries[i].Chip)
+      Entries[Len - 1].Mask |= Entries[i].Mask;
+    else
+      Entries[Len++] = Entries[i];
+  }
+
+  for (uint16_t i = 0; i < Len; i++)
+  {
+    uint8_t Mask = Entries[i].Mask;
+
+    Entries[i].Skip = Entries[i].Chip - (i ? Entries[i - 1].Chip + 1 : 0);
+    for (; Mask; Mask &= Mask - 1)
+      Bits++;
+  }
+
+  Plan->Entries = Entries;
+  Plan->EntryCount = Len;
+  Plan->Length = Entries[Len - 1].Chip + 1;
+  Plan->Bits = Bits;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Read the bits selected by a plan.
+ * @note   The chain is loaded once and shifted only up to the last chip of the
+ *         plan. Bytes between the chips are not stored. Selected bits are
+ *         packed from bit 0 of Out[0] upward, in chip order and from bit 0 to
+ *         bit 7 of each chip.
+ * @param  Handler: Pointer to handler
+ * @param  Plan: Pointer to plan built by IC74165_Plan_Init
+ * @param  Out: Pointer to a buffer of (Plan->Bits + 7) / 8 bytes
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadPlan(IC74165_Handler_t *Handler, const IC74165_Plan_t *Plan,
+                 uint8_t *Out)
+{
+  IC74165_Result_t Result;
+
+  if (Handler->ChainLen == 0 || Plan->EntryCount == 0 ||
+      Plan->Length > Handler->ChainLen)
+    return IC74165_FAIL;
+
+  if (Handler->Async.State != IC74165_ASYNC_IDLE)
+    return IC74165_BUSY;
+
+  memset(Out, 0, (Plan->Bits + 7) / 8);
+
+  if (!IC74165_BusAcquire(Handler, 1))
+    return IC74165_FAIL;
+
+  IC74165_StatsBegin(Handler);
+  IC74165_Load(Handler);
+
+  Result = IC74165_ShiftInPlan(Handler, Plan, Out);
+  IC74165_StatsEnd(Handler);
+
+  IC74165_BusRelease(Handler);
+
+  return Result;
+}
+
+
+/**
+ * @brief  Multi-chain initialization function.
+ * @note   Link shared pins to Multi->Handler and PortRead before calling it.
+ * @param  Multi: Pointer to multi-chain handler
+ * @param  ChainCount: Number of parallel chains (1 to 32)
+ * @param  ChainLen: Number of chained 74165 in the longest chain
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Multi_Init(IC74165_Multi_t *Multi, uint8_t ChainCount, uint16_t ChainLen)
+{
+  IC74165_Handler_t *Handler = &Multi->Handler;
+
+  if (ChainCount == 0 || ChainCount > 32 || Multi->PortRead == NULL)
+    return IC74165_FAIL;
+
+  if (Handler->Platform.Communication != IC74165_COMMUNICATION_GPIO ||
+      Handler->Platform.GPIO.ClkWrite == NULL ||
+      Handler->Platform.GPIO.ShLdWrite == NULL ||
+      (Handler->Platform.GPIO.DelayUs == NULL &&
+       Handler->Platform.GPIO.DelayNs == NULL))
+    return IC74165_FAIL;
+
+  if (IC74165_TimingInit(Handler) != IC74165_OK)
+    return IC74165_FAIL;
+
+  if (Handler->Platform.Init)
+    Handler->Platform.Init();
+
+  if (ChainLen == 0)
+    ChainLen = 1;
+
+  Handler->ChainLen = ChainLen;
+  Multi->ChainCount = ChainCount;
+#if (IC74165_CONFIG_STATS)
+  IC74165_Stats_Reset(Handler);
+#endif
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Multi-chain de-initialization function.
+ * @param  Multi: Pointer to multi-chain handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Multi_DeInit(IC74165_Multi_t *Multi)
+{
+  Multi->ChainCount = 0;
+  return IC74165_DeInit(&Multi->Handler);
+}
+
+
+/**
+ * @brief  Read all chains with one clock sequence.
+ * @param  Multi: Pointer to multi-chain handler
+ * @param  Data: Pointer to a buffer of ChainCount * ChainLen bytes. Data of
+ *               chain n is stored at Data[n * ChainLen].
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Multi_ReadAll(IC74165_Multi_t *Multi, uint8_t *Data)
+{
+  if (Multi->ChainCount == 0 || Multi->Handler.ChainLen == 0)
+    return IC74165_FAIL;
+
+  if (!IC74165_BusAcquire(&Multi->Handler, 1))
+    return IC74165_FAIL;
+
+  IC74165_StatsBegin(&Multi->Handler);
+  IC74165_Load(&Multi->Handler);
+  IC74165_Multi_ShiftIn(Multi, Data);
+  IC74165_StatsEnd(&Multi->Handler);
+
+  IC74165_BusRelease(&Multi->Handler);
+
+  return IC74165_OK;
+}
+
+
+#if (IC74165_CONFIG_STATS)
+/**
+ * @brief  Clear scan instrumentation of the handler.
+ * @note   It is called by IC74165_Init.
+ * @param  Handler: Pointer to handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ */
+IC74165_Result_t
+IC74165_Stats_Reset(IC74165_Handler_t *Handler)
+{
+  memset(&Handler->Stats, 0, sizeof(IC74165_Stats_t));
+  Handler->Stats.MinTime = UINT32_MAX;
+  Handler->Stats.MinInterval = UINT32_MAX;
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Mean scan time.
+ * @param  Handler: Pointer to handler
+ * @retval Mean scan time in ticks (0 if there is no scan)
+ */
+uint32_t
+IC74165_Stats_MeanTime(IC74165_Handler_t *Handler)
+{
+  if (Handler->Stats.Scans == 0)
+    return 0;
+  return (uint32_t)(Handler->Stats.TotalTime / Handler->Stats.Scans);
+}
+#endif
+
+
+#if (IC74165_CONFIG_CACHE)
+/**
+ * @brief  Enable the read-through cache of the handler.
+ * @note   After it, Read and ReadOne are served from the last full snapshot
+ *         while it is younger than MaxAge. An older snapshot is refreshed with
+ *         one ReadAll. ReadAll always reads the chain and refreshes the cache.
+ * @param  Handler: Pointer to initialized handler. GetTick must be linked.
+ * @param  Buffer: Pointer to a buffer of ChainLen bytes for the snapshot
+ * @param  MaxAge: Maximum age of the snapshot (ticks of GetTick)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Cache_Init(IC74165_Handler_t *Handler, uint8_t *Buffer, uint32_t MaxAge)
+{
+  if (Handler->ChainLen == 0 ||
+      Handler->Platform.GetTick == NULL ||
+      Buffer == NULL)
+    return IC74165_FAIL;
+
+  if (MaxAge == IC74165_CACHE_MAXAGE_HANDLER)
+    MaxAge--;
+
+  Handler->Cache.Buffer = Buffer;
+  Handler->Cache.MaxAge = MaxAge;
+  Handler->Cache.Valid = 0;
+  Handler->Cache.Hits = 0;
+  Handler->Cache.Misses = 0;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Drop the cached snapshot. The next read refreshes it.
+ * @param  Handler: Pointer to handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ */
+IC74165_Result_t
+IC74165_Cache_Invalidate(IC74165_Handler_t *Handler)
+{
+  Handler->Cache.Valid = 0;
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Read chain through the cache with a maximum age for this call.
+ * @param  Handler: Pointer to handler
+ * @param  Data: Pointer to a buffer to store data
+ * @param  Pos: Start position in chain
+ * @param  Count: Number of bytes to read from chain
+ * @param  MaxAge: Maximum age of the snapshot (ticks of GetTick), or
+ *                 IC74165_CACHE_MAXAGE_HANDLER to use the one of the handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadCached(IC74165_Handler_t *Handler, uint8_t *Data,
+                   uint16_t Pos, uint16_t Count, uint32_t MaxAge)
+{
+  uint32_t Now;
+
+  if (Handler->ChainLen == 0 || Handler->Cache.Buffer == NULL)
+    return IC74165_FAIL;
+
+  if (Pos >= Handler->ChainLen)
+    return IC74165_FAIL;
+
+  if ((uint32_t)Count + Pos > Handler->ChainLen)
+    Count = Handler->ChainLen - Pos;
+
+  if (MaxAge == IC74165_CACHE_MAXAGE_HANDLER)
+    MaxAge = Handler->Cache.MaxAge;
+
+  // The age is computed with unsigned subtraction, so tick wrap is harmless
+  Now = Handler->Platform.GetTick();
+  if (!Handler->Cache.Valid ||
+      (uint32_t)(Now - Handler->Cache.Stamp) >= MaxAge)
+  {
+    IC74165_Result_t Result;
+
+    Handler->Cache.Misses++;
+    Result = IC74165_Scan(Handler, Handler->Cache.Buffer,
+                          0, Handler->ChainLen, 1);
+    if (Result != IC74165_OK)
+    {
+      Handler->Cache.Valid = 0;
+      return Result;
+    }
+    Handler->Cache.Stamp = Now;
+    Handler->Cache.Valid = 1;
+  }
+  else
+  {
+    Handler->Cache.Hits++;
+  }
+
+  memcpy(Data, &Handler->Cache.Buffer[Pos], Count);
+
+  return IC74165_OK;
+}
+#endif
+
+
+#if (IC74165_CONFIG_INTEGRITY)
+/**
+ * @brief  Find the physical chain length.
+ * @note   The chain is loaded and shifted MaxLen + 1 bytes. The bytes after
+ *         the last chip are the SER fill of Handler->Integrity, so the chain
+ *         ends at the last byte that differs from it. Without a marker, a last
+ *         chip whose inputs all equal the fill is not counted.
+ * @param  Handler: Pointer to initialized handler (any ChainLen)
+ * @param  MaxLen: Maximum number of chained 74165
+ * @param  ChainLen: Pointer to store the length. Pass it to IC74165_InitWide.
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful (no chip found or the
+ *                         chain is longer than MaxLen).
+ *         - IC74165_CORRUPT: The marker is not found in the last chip.
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_Probe(IC74165_Handler_t *Handler, uint16_t MaxLen, uint16_t *ChainLen)
+{
+  IC74165_Result_t Result = IC74165_OK;
+  uint8_t Buffer[16];
+  uint8_t LastByte = 0;
+  uint32_t Last = 0;
+  uint32_t Pos = 0;
+
+  if (Handler->ChainLen == 0 || MaxLen == 0 || ChainLen == NULL)
+    return IC74165_FAIL;
+
+  if (Handler->Async.State != IC74165_ASYNC_IDLE)
+    return IC74165_BUSY;
+
+  if (!IC74165_BusAcquire(Handler, 1))
+    return IC74165_FAIL;
+
+  IC74165_Load(Handler);
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(0);
+
+  while (Pos <= MaxLen)
+  {
+    uint32_t Len = (uint32_t)MaxLen + 1 - Pos;
+    if (Len > sizeof(Buffer))
+      Len = sizeof(Buffer);
+
+    Result = IC74165_Shift(Handler, Buffer, (uint16_t)Len);
+    if (Result != IC74165_OK)
+      break;
+
+    for (uint32_t i = 0; i < Len; i++)
+    {
+      if (Buffer[i] != Handler->Integrity.Fill)
+      {
+        Last = Pos + i + 1;
+        LastByte = Buffer[i];
+      }
+    }
+    Pos += Len;
+  }
+
+  if (Handler->Platform.ClkInhWrite)
+    Handler->Platform.ClkInhWrite(1);
+
+  IC74165_BusRelease(Handler);
+
+  if (Result != IC74165_OK || Last == 0 || Last > MaxLen)
+    return IC74165_FAIL;
+
+  if ((LastByte & Handler->Integrity.MarkerMask) != Handler->Integrity.Marker)
+    return IC74165_CORRUPT;
+
+  *ChainLen = (uint16_t)Last;
+
+  return IC74165_OK;
 }
+#endif
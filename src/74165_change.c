@@ -0,0 +1,257 @@
+/**
+ **********************************************************************************
+ * @file   74165_change.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Change detection over consecutive 74165 chain scans
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include "74165_change.h"
+#include <stddef.h>
+#include <string.h>
+
+
+/* Private Macros ---------------------------------------------------------------*/
+#define IC74165_CHANGE_WORD_SIZE  sizeof(IC74165_ChangeWord_t)
+
+/**
+ * @brief  Byte offset in the word of a bit index returned by ctz
+ */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define IC74165_CHANGE_BYTE_OF(BIT) \
+  ((IC74165_CHANGE_WORD_SIZE - 1) - ((BIT) >> 3))
+#else
+#define IC74165_CHANGE_BYTE_OF(BIT) ((BIT) >> 3)
+#endif
+
+
+
+/**
+ ==================================================================================
+                          ##### Private Functions #####                            
+ ==================================================================================
+ */
+
+static inline uint8_t
+IC74165_Change_Ctz(IC74165_ChangeWord_t Word)
+{
+#if defined(__GNUC__) && (IC74165_CHANGE_WORD_64)
+  return (uint8_t)__builtin_ctzll(Word);
+#elif defined(__GNUC__)
+  return (uint8_t)__builtin_ctzl(Word);
+#else
+  uint8_t Count = 0;
+  while ((Word & 1) == 0)
+  {
+    Word >>= 1;
+    Count++;
+  }
+  return Count;
+#endif
+}
+
+static inline IC74165_ChangeWord_t
+IC74165_Change_Diff(IC74165_Change_t *Change, uint32_t Offset)
+{
+  IC74165_ChangeWord_t Prev = 0;
+  IC74165_ChangeWord_t Curr = 0;
+  uint32_t Size = Change->Len - Offset;
+
+  if (Size >= IC74165_CHANGE_WORD_SIZE)
+  {
+    memcpy(&Prev, &Change->Prev[Offset], IC74165_CHANGE_WORD_SIZE);
+    memcpy(&Curr, &Change->Curr[Offset], IC74165_CHANGE_WORD_SIZE);
+  }
+  else
+  {
+    memcpy(&Prev, &Change->Prev[Offset], Size);
+    memcpy(&Curr, &Change->Curr[Offset], Size);
+  }
+
+  return Prev ^ Curr;
+}
+
+
+
+/**
+ ==================================================================================
+                           ##### Public Functions #####                            
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize change tracker.
+ * @param  Change: Pointer to change tracker
+ * @param  Handler: Pointer to initialized handler
+ * @param  Buffer: Pointer to a buffer of 2 * ChainLen bytes for snapshots
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Change_Init(IC74165_Change_t *Change, IC74165_Handler_t *Handler,
+                    uint8_t *Buffer)
+{
+  if (Handler == NULL || Buffer == NULL || Handler->ChainLen == 0)
+    return IC74165_FAIL;
+
+  Change->Handler = Handler;
+  Change->Len = Handler->ChainLen;
+  Change->Prev = Buffer;
+  Change->Curr = Buffer + Change->Len;
+  Change->Valid = 0;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Read all chained devices and compare them with the previous scan.
+ * @param  Change: Pointer to change tracker
+ * @param  Changed: Pointer to store the result (can be NULL)
+ *         - 0: Nothing changed (always 0 for the first scan)
+ *         - 1: At least one input changed
+ * @note   If Callback is set, it will be called for each edge.
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Change_Scan(IC74165_Change_t *Change, uint8_t *Changed)
+{
+  IC74165_Result_t Result;
+  uint8_t *Swap;
+  uint8_t Diff = 0;
+
+  // Read into the stale buffer, so a failed scan keeps the last good one
+  Result = IC74165_ReadAll(Change->Handler, Change->Prev);
+  if (Result != IC74165_OK)
+    return Result;
+
+  Swap = Change->Prev;
+  Change->Prev = Change->Curr;
+  Change->Curr = Swap;
+
+  if (Change->Valid)
+  {
+    for (uint32_t Offset = 0; Offset < Change->Len;
+         Offset += IC74165_CHANGE_WORD_SIZE)
+    {
+      if (IC74165_Change_Diff(Change, Offset))
+      {
+        Diff = 1;
+        break;
+      }
+    }
+  }
+  else
+  {
+    memcpy(Change->Prev, Change->Curr, Change->Len);
+    Change->Valid = 1;
+  }
+
+  if (Diff && Change->Callback)
+  {
+    IC74165_ChangeIter_t Iter;
+    uint32_t Bit;
+    uint8_t Level;
+
+    IC74165_Change_IterInit(Change, &Iter);
+    while (IC74165_Change_IterNext(Change, &Iter, &Bit, &Level))
+      Change->Callback(Change->Ctx, Bit, Level);
+  }
+
+  if (Changed)
+    *Changed = Diff;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Get the last snapshot.
+ * @param  Change: Pointer to change tracker
+ * @retval Pointer to ChainLen bytes of the last scan
+ */
+const uint8_t *
+IC74165_Change_Data(IC74165_Change_t *Change)
+{
+  return Change->Curr;
+}
+
+
+/**
+ * @brief  Start iterating over the edges of the last scan.
+ * @param  Change: Pointer to change tracker
+ * @param  Iter: Pointer to iterator
+ * @retval None
+ */
+void
+IC74165_Change_IterInit(IC74165_Change_t *Change, IC74165_ChangeIter_t *Iter)
+{
+  (void)Change;
+  Iter->Offset = 0;
+  Iter->Pending = 0;
+}
+
+
+/**
+ * @brief  Get the next edge of the last scan.
+ * @param  Change: Pointer to change tracker
+ * @param  Iter: Pointer to iterator
+ * @param  Bit: Pointer to store bit index in chain (Byte * 8 + Bit of byte)
+ * @param  Level: Pointer to store new level of the input (can be NULL)
+ * @retval 
+ *         - 0: No more edges
+ *         - 1: An edge is stored in Bit and Level
+ */
+uint8_t
+IC74165_Change_IterNext(IC74165_Change_t *Change, IC74165_ChangeIter_t *Iter,
+                        uint32_t *Bit, uint8_t *Level)
+{
+  uint8_t WordBit;
+  uint32_t Byte;
+
+  while (Iter->Pending == 0)
+  {
+    if (Iter->Offset >= Change->Len)
+      return 0;
+
+    Iter->Pending = IC74165_Change_Diff(Change, Iter->Offset);
+    Iter->Offset += IC74165_CHANGE_WORD_SIZE;
+  }
+
+  WordBit = IC74165_Change_Ctz(Iter->Pending);
+  Iter->Pending &= Iter->Pending - 1;
+
+  Byte = Iter->Offset - IC74165_CHANGE_WORD_SIZE + IC74165_CHANGE_BYTE_OF(WordBit);
+  *Bit = Byte * 8 + (WordBit & 7);
+  if (Level)
+    *Level = (Change->Curr[Byte] >> (WordBit & 7)) & 1;
+
+  return 1;
+}
@@ -0,0 +1,180 @@
+/**
+ **********************************************************************************
+ * @file   74165_debounce.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Bit-parallel debouncer for 74165 chain inputs
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include "74165_debounce.h"
+#include <stddef.h>
+#include <string.h>
+
+
+
+/**
+ ==================================================================================
+                           ##### Public Functions #####                            
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize debouncer.
+ * @param  Debounce: Pointer to debouncer
+ * @param  Handler: Pointer to initialized handler for IC74165_Debounce_Scan
+ *                  (can be NULL if only IC74165_Debounce_Update is used)
+ * @param  Len: Number of bytes of inputs (chain length)
+ * @param  Depth: Number of consecutive equal samples to accept a new level
+ * @param  Buffer: Pointer to a buffer of IC74165_DEBOUNCE_BUFFER_SIZE(Len) bytes
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Debounce_Init(IC74165_Debounce_t *Debounce, IC74165_Handler_t *Handler,
+                      uint16_t Len, uint8_t Depth, uint8_t *Buffer)
+{
+  if (Buffer == NULL || Len == 0 || Depth == 0 ||
+      Depth > (1U << IC74165_DEBOUNCE_COUNTER_BITS) - 1)
+    return IC74165_FAIL;
+  if (Handler != NULL && Handler->ChainLen != Len)
+    return IC74165_FAIL;
+
+  Debounce->Handler = Handler;
+  Debounce->Len = Len;
+  Debounce->Depth = Depth;
+  Debounce->State = Buffer;
+  Debounce->Sample = Buffer + Len;
+  Debounce->Counter = Buffer + 2 * Len;
+  Debounce->Valid = 0;
+  memset(Debounce->Counter, 0, IC74165_DEBOUNCE_COUNTER_BITS * Len);
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Feed a new snapshot to the debouncer.
+ * @param  Debounce: Pointer to debouncer
+ * @param  Sample: Pointer to Len bytes of raw inputs (e.g. from IC74165_ReadAll)
+ * @param  Changed: Pointer to store the result (can be NULL)
+ *         - 0: No debounced input changed
+ *         - 1: At least one debounced input changed
+ * @retval None
+ */
+void
+IC74165_Debounce_Update(IC74165_Debounce_t *Debounce, const uint8_t *Sample,
+                        uint8_t *Changed)
+{
+  uint8_t *State = Debounce->State;
+  uint8_t *Counter = Debounce->Counter;
+  uint16_t Len = Debounce->Len;
+  uint8_t Depth = Debounce->Depth;
+  uint8_t Toggled = 0;
+
+  if (!Debounce->Valid)
+  {
+    if (State != Sample)
+      memcpy(State, Sample, Len);
+    Debounce->Valid = 1;
+    if (Changed)
+      *Changed = 0;
+    return;
+  }
+
+  for (uint16_t i = 0; i < Len; i++)
+  {
+    uint8_t Delta = Sample[i] ^ State[i];
+    uint8_t Carry = Delta;
+    uint8_t Equal = Delta;
+
+    // Increment the counters of differing bits, clear the others
+    for (uint8_t k = 0; k < IC74165_DEBOUNCE_COUNTER_BITS; k++)
+    {
+      uint8_t Plane = Counter[k * Len + i];
+      Counter[k * Len + i] = (Plane ^ Carry) & Delta;
+      Carry &= Plane;
+    }
+
+    // Bits whose counter reached Depth take the new level
+    for (uint8_t k = 0; k < IC74165_DEBOUNCE_COUNTER_BITS; k++)
+    {
+      uint8_t Plane = Counter[k * Len + i];
+      Equal &= ((Depth >> k) & 1) ? Plane : (uint8_t)~Plane;
+    }
+
+    if (Equal)
+    {
+      State[i] ^= Equal;
+      for (uint8_t k = 0; k < IC74165_DEBOUNCE_COUNTER_BITS; k++)
+        Counter[k * Len + i] &= (uint8_t)~Equal;
+      Toggled = 1;
+    }
+  }
+
+  if (Changed)
+    *Changed = Toggled;
+}
+
+
+/**
+ * @brief  Read all chained devices through the handler given to
+ *         IC74165_Debounce_Init and feed them to the debouncer.
+ * @param  Debounce: Pointer to debouncer
+ * @param  Changed: Pointer to store the result (can be NULL)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Debounce_Scan(IC74165_Debounce_t *Debounce, uint8_t *Changed)
+{
+  IC74165_Result_t Result;
+
+  if (Debounce->Handler == NULL || Debounce->Handler->ChainLen != Debounce->Len)
+    return IC74165_FAIL;
+
+  Result = IC74165_ReadAll(Debounce->Handler, Debounce->Sample);
+  if (Result != IC74165_OK)
+    return Result;
+
+  IC74165_Debounce_Update(Debounce, Debounce->Sample, Changed);
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Get the debounced inputs.
+ * @param  Debounce: Pointer to debouncer
+ * @retval Pointer to Len bytes of debounced inputs
+ */
+const uint8_t *
+IC74165_Debounce_Data(IC74165_Debounce_t *Debounce)
+{
+  return Debounce->State;
+}
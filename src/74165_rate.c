@@ -0,0 +1,195 @@
+/**
+ **********************************************************************************
+ * @file   74165_rate.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Adaptive scan rate controller for 74165 chain
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include "74165_rate.h"
+#include <stddef.h>
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+IC74165_Rate_Clamp(IC74165_Rate_t *Rate)
+{
+  if (Rate->Period < Rate->MinPeriod)
+    Rate->Period = Rate->MinPeriod;
+  if (Rate->Period > Rate->MaxPeriod)
+    Rate->Period = Rate->MaxPeriod;
+}
+
+
+
+/**
+ ==================================================================================
+                           ##### Public Functions #####                            
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize adaptive scan rate controller.
+ * @param  Rate: Pointer to controller
+ * @param  Change: Pointer to initialized change tracker
+ * @param  MinPeriod: Scan period while inputs change
+ * @param  MaxPeriod: Scan period when inputs are idle
+ * @param  Hysteresis: Number of scans without change before each slow down
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Rate_Init(IC74165_Rate_t *Rate, IC74165_Change_t *Change,
+                  uint32_t MinPeriod, uint32_t MaxPeriod, uint16_t Hysteresis)
+{
+  if (Change == NULL)
+    return IC74165_FAIL;
+
+  Rate->Change = Change;
+  Rate->Period = MinPeriod;
+  Rate->LastScan = 0;
+  Rate->Started = 0;
+
+  return IC74165_Rate_SetLimits(Rate, MinPeriod, MaxPeriod, Hysteresis);
+}
+
+
+/**
+ * @brief  Scan the chain if the current period is elapsed and adapt the period.
+ * @note   Call it from a task loop faster than MinPeriod.
+ * @param  Rate: Pointer to controller
+ * @param  Now: Current time
+ * @param  Changed: Pointer to store change status (can be NULL)
+ *         - 0: No scan or no input changed
+ *         - 1: Scanned and at least one input changed
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Rate_Poll(IC74165_Rate_t *Rate, uint32_t Now, uint8_t *Changed)
+{
+  IC74165_Result_t Result;
+  uint8_t Diff = 0;
+
+  if (Changed)
+    *Changed = 0;
+
+  if (Rate->Started && (uint32_t)(Now - Rate->LastScan) < Rate->Period)
+    return IC74165_OK;
+
+  Rate->Started = 1;
+  Rate->LastScan = Now;
+
+  Result = IC74165_Change_Scan(Rate->Change, &Diff);
+  if (Result != IC74165_OK)
+    return Result;
+
+  if (Diff)
+  {
+    // Activity: scan as fast as allowed
+    Rate->Period = Rate->MinPeriod;
+    Rate->Quiet = 0;
+  }
+  else if (++Rate->Quiet >= Rate->Hysteresis)
+  {
+    // Idle: slow down step by step
+    Rate->Quiet = 0;
+    if (Rate->Period > Rate->MaxPeriod / 2)
+      Rate->Period = Rate->MaxPeriod;
+    else
+      Rate->Period *= 2;
+  }
+
+  if (Changed)
+    *Changed = Diff;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Change the limits of the controller.
+ * @note   The current period is clamped to the new limits.
+ * @param  Rate: Pointer to controller
+ * @param  MinPeriod: Scan period while inputs change
+ * @param  MaxPeriod: Scan period when inputs are idle
+ * @param  Hysteresis: Number of scans without change before each slow down
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Rate_SetLimits(IC74165_Rate_t *Rate, uint32_t MinPeriod,
+                       uint32_t MaxPeriod, uint16_t Hysteresis)
+{
+  if (MinPeriod == 0 || MinPeriod > MaxPeriod)
+    return IC74165_FAIL;
+
+  if (Hysteresis == 0)
+    Hysteresis = 1;
+
+  Rate->MinPeriod = MinPeriod;
+  Rate->MaxPeriod = MaxPeriod;
+  Rate->Hysteresis = Hysteresis;
+  Rate->Quiet = 0;
+  IC74165_Rate_Clamp(Rate);
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Get the current scan period.
+ * @param  Rate: Pointer to controller
+ * @retval Current scan period
+ */
+uint32_t
+IC74165_Rate_GetPeriod(IC74165_Rate_t *Rate)
+{
+  return Rate->Period;
+}
+
+
+/**
+ * @brief  Get the time of the next scan.
+ * @note   It can be used to sleep until the next call to IC74165_Rate_Poll.
+ * @param  Rate: Pointer to controller
+ * @retval Time of the next scan
+ */
+uint32_t
+IC74165_Rate_GetNextScan(IC74165_Rate_t *Rate)
+{
+  return Rate->LastScan + Rate->Period;
+}
@@ -0,0 +1,185 @@
+/**
+ **********************************************************************************
+ * @file   74165_scanner.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Periodic 74165 chain scanner with lock-free snapshot
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include "74165_scanner.h"
+#include <stddef.h>
+#include <string.h>
+
+
+
+/**
+ ==================================================================================
+                           ##### Public Functions #####                            
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize scanner.
+ * @param  Scanner: Pointer to scanner
+ * @param  Handler: Pointer to initialized handler
+ * @param  Period: Scan period (in the unit of Now passed to IC74165_Scanner_Poll)
+ * @param  Buffer: Pointer to a buffer of IC74165_SCANNER_BUFFER_SIZE(ChainLen)
+ *                 bytes
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Scanner_Init(IC74165_Scanner_t *Scanner, IC74165_Handler_t *Handler,
+                     uint32_t Period, uint8_t *Buffer)
+{
+  if (Handler == NULL || Buffer == NULL || Handler->ChainLen == 0)
+    return IC74165_FAIL;
+
+  Scanner->Handler = Handler;
+  Scanner->Period = Period;
+  Scanner->Buffer = Buffer;
+  Scanner->Len = Handler->ChainLen;
+  Scanner->Seq = 0;
+  Scanner->Timestamp[0] = 0;
+  Scanner->Timestamp[1] = 0;
+  Scanner->LastScan = 0;
+  Scanner->Started = 0;
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Scan the chain and publish the result.
+ * @note   Call it from a periodic timer or task. If the read fails, nothing is
+ *         published and readers keep the last snapshot.
+ * @param  Scanner: Pointer to scanner
+ * @param  Now: Current time. It will be stored as the snapshot timestamp.
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Scanner_Scan(IC74165_Scanner_t *Scanner, uint32_t Now)
+{
+  IC74165_Result_t Result;
+  uint32_t Seq = Scanner->Seq;
+  uint32_t Next = Seq + 1;
+  uint8_t Index;
+
+  // Seq counts published snapshots, 0 means none. Readers use copy (Seq & 1),
+  // so the scan goes to the other copy. 0 is skipped on wrap; the parity
+  // still alternates.
+  if (Next == 0)
+    Next = 2;
+  Index = Next & 1;
+
+  Scanner->LastScan = Now;
+  Scanner->Started = 1;
+
+  Result = IC74165_ReadAll(Scanner->Handler, Scanner->Buffer + Index * Scanner->Len);
+  if (Result != IC74165_OK)
+    return Result;
+  Scanner->Timestamp[Index] = Now;
+
+  // Release: the snapshot is complete before readers can see the new Seq
+  IC74165_SCANNER_BARRIER();
+  Scanner->Seq = Next;
+  // The next scan overwrites the copy of the old Seq. Its stores must come
+  // after the new Seq, so a reader still on that copy fails its check.
+  IC74165_SCANNER_BARRIER();
+
+  return IC74165_OK;
+}
+
+
+/**
+ * @brief  Scan the chain if the scan period is elapsed.
+ * @note   Call it from a task loop faster than the scan period.
+ * @param  Scanner: Pointer to scanner
+ * @param  Now: Current time
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Scanner_Poll(IC74165_Scanner_t *Scanner, uint32_t Now)
+{
+  if (Scanner->Started && (uint32_t)(Now - Scanner->LastScan) < Scanner->Period)
+    return IC74165_OK;
+
+  return IC74165_Scanner_Scan(Scanner, Now);
+}
+
+
+/**
+ * @brief  Get a consistent copy of the last published snapshot.
+ * @note   It can be called from any number of tasks at the same time. It does
+ *         not use any lock and does not touch the bus.
+ * @param  Scanner: Pointer to scanner
+ * @param  Data: Pointer to a buffer of ChainLen bytes
+ * @param  Generation: Pointer to store number of published scans (can be NULL).
+ *                     It skips 0 when it wraps.
+ * @param  Timestamp: Pointer to store time of the snapshot (can be NULL)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: No snapshot is published yet.
+ */
+IC74165_Result_t
+IC74165_Scanner_Get(IC74165_Scanner_t *Scanner, uint8_t *Data,
+                    uint32_t *Generation, uint32_t *Timestamp)
+{
+  uint32_t Seq;
+  uint32_t Stamp;
+  uint8_t Index;
+
+  do
+  {
+    Seq = Scanner->Seq;
+    // Acquire: the copy is read after Seq
+    IC74165_SCANNER_BARRIER();
+
+    if (Seq == 0)
+      return IC74165_FAIL;
+
+    Index = Seq & 1;
+    memcpy(Data, Scanner->Buffer + Index * Scanner->Len, Scanner->Len);
+    Stamp = Scanner->Timestamp[Index];
+
+    // The copy is complete before Seq is checked again
+    IC74165_SCANNER_BARRIER();
+  } while (Scanner->Seq != Seq);
+
+  if (Generation)
+    *Generation = Seq;
+  if (Timestamp)
+    *Timestamp = Stamp;
+
+  return IC74165_OK;
+}
@@ -38,6 +38,50 @@ extern "C" {
 
 /* Includes ---------------------------------------------------------------------*/
 #include <stdint.h>
+#include <stddef.h>
+
+
+/* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Scan instrumentation (counters, scan time and histogram)
+ *         - 0: Disabled. Nothing is added to the handler or the read functions.
+ *         - 1: Enabled. Link GetTick to measure scan time.
+ * @note   It changes the handler layout, so define it for the whole project
+ *         (e.g. as a compiler flag), not in a single source file.
+ */
+#ifndef IC74165_CONFIG_STATS
+#define IC74165_CONFIG_STATS  0
+#endif
+
+/**
+ * @brief  Number of buckets of the scan time histogram. Bucket n counts the
+ *         scans that took [2^(n-1), 2^n) ticks; the last bucket also counts
+ *         longer scans.
+ */
+#ifndef IC74165_STATS_BUCKETS
+#define IC74165_STATS_BUCKETS 16
+#endif
+
+/**
+ * @brief  Read-through snapshot cache for Read/ReadOne
+ *         - 0: Disabled. Nothing is added to the handler or the read functions.
+ *         - 1: Enabled. Link GetTick and call IC74165_Cache_Init.
+ * @note   It changes the handler layout, so define it for the whole project.
+ */
+#ifndef IC74165_CONFIG_CACHE
+#define IC74165_CONFIG_CACHE  0
+#endif
+
+/**
+ * @brief  In-band integrity check and chain length probe
+ *         - 0: Disabled. Nothing is added to the handler or the read functions.
+ *         - 1: Enabled. Set Handler.Integrity before IC74165_Init.
+ * @note   It changes the handler layout, so define it for the whole project.
+ */
+#ifndef IC74165_CONFIG_INTEGRITY
+#define IC74165_CONFIG_INTEGRITY  0
+#endif
+
 
 
 /* Exported Data Types ----------------------------------------------------------*/
@@ -49,6 +93,8 @@ typedef enum IC74165_Result_e
 {
   IC74165_OK      = 0,
   IC74165_FAIL    = -1,
+  IC74165_BUSY    = -2,
+  IC74165_CORRUPT = -3,
 } IC74165_Result_t;
 
 /**
@@ -60,6 +106,33 @@ typedef enum IC74165_Communication_e
   IC74165_COMMUNICATION_SPI   = 1,
 } IC74165_Communication_t;
 
+/**
+ * @brief  74165 chip family. It is used to validate the timing profile.
+ */
+typedef enum IC74165_Family_e
+{
+  IC74165_FAMILY_HC   = 0,  // 74HC165 (4.5V)
+  IC74165_FAMILY_HCT  = 1,  // 74HCT165 (4.5V)
+  IC74165_FAMILY_LS   = 2,  // 74LS165 (5V)
+  IC74165_FAMILY_LV   = 3,  // 74LV165A (3.3V)
+} IC74165_Family_t;
+
+/**
+ * @brief  Timing profile in nanoseconds
+ * @note   A zero field means the minimum value of the declared chip family.
+ */
+typedef struct IC74165_Timing_s
+{
+  // Pulse width of SH/LD low level
+  uint16_t LoadPulse;
+  // Pulse width of CLK high level
+  uint16_t ClkHigh;
+  // Pulse width of CLK low level
+  uint16_t ClkLow;
+  // Setup time of Qh after SH/LD or CLK edge, before it is sampled
+  uint16_t Setup;
+} IC74165_Timing_t;
+
 
 /**
  * @brief  Function type for Initialize/Deinitialize the platform dependent layer.
@@ -80,38 +153,158 @@ typedef void (*IC74165_Platform_SetLevelGPIO_t)(uint8_t Level);
  */
 typedef uint8_t (*IC74165_Platform_GetLevelGPIO_t)(void);
 
+/**
+ * @brief  Function type for read a whole GPIO port.
+ * @retval Levels of port pins. Bit n is the Qh level of chain n.
+ */
+typedef uint32_t (*IC74165_Platform_GetPortGPIO_t)(void);
+
+/**
+ * @brief  Function type for acquire the bus shared with other devices.
+ * @param  Block: 1 to wait until the bus is free, 0 to return immediately
+ * @retval 
+ *         - 0: Bus is not acquired (busy)
+ *         - 1: Bus is acquired
+ */
+typedef uint8_t (*IC74165_Platform_BusAcquire_t)(uint8_t Block);
+
+/**
+ * @brief  Function type for release the bus acquired by BusAcquire.
+ */
+typedef void (*IC74165_Platform_BusRelease_t)(void);
+
+/**
+ * @brief  Function type for get a free running timestamp.
+ * @retval Current time in ticks of any unit (e.g. us or CPU cycles). It may
+ *         wrap around.
+ */
+typedef uint32_t (*IC74165_Platform_GetTick_t)(void);
+
 /**
  * @brief  Function type for delay.
  * @param  Delay: Delay duration
  */
 typedef void (*IC74165_Platform_Delay_t)(uint8_t Delay);
 
+/**
+ * @brief  Function type for delay in nanoseconds.
+ * @param  Delay: Delay duration (ns)
+ */
+typedef void (*IC74165_Platform_DelayNs_t)(uint16_t Delay);
+
 /**
  * @brief  Function type for Send/Receive data to/from the slave through SPI.
  * @param  SendData: Pointer to data to send
  * @param  ReceiveData: Pointer to data to receive
  * @param  Len: data len in Bytes
- * @note   If SendData is NULL, the function must receive data.
- * @note   If ReceiveData is NULL, the function must send data.
+ * @note   If SendData is NULL, the function must send 0xFF bytes (SH/LD high).
+ * @note   If ReceiveData is NULL, the received data must be discarded.
  */
 typedef void (*IC74165_Platform_SPI_SendReceive_t)(uint8_t *SendData,
                                                    uint8_t *ReceiveData,
                                                    uint8_t Len);
 
+/**
+ * @brief  Function type for Send/Receive data to/from the slave through SPI
+ *         without the 255 bytes limit.
+ * @param  SendData: Pointer to data to send
+ * @param  ReceiveData: Pointer to data to receive
+ * @param  Len: data len in Bytes
+ * @note   Same rules as IC74165_Platform_SPI_SendReceive_t.
+ */
+typedef void (*IC74165_Platform_SPI_SendReceiveWide_t)(uint8_t *SendData,
+                                                       uint8_t *ReceiveData,
+                                                       size_t Len);
+
+/**
+ * @brief  Function type for start a Send/Receive through SPI without waiting
+ *         for it.
+ * @param  SendData: Pointer to data to send
+ * @param  ReceiveData: Pointer to data to receive
+ * @param  Len: data len in Bytes
+ * @note   Same rules as IC74165_Platform_SPI_SendReceive_t. The buffers must
+ *         stay valid until IsComplete returns 1.
+ * @retval 
+ *         - 0: Transfer is not started
+ *         - 1: Transfer is started
+ */
+typedef uint8_t (*IC74165_Platform_SPI_StartTransfer_t)(uint8_t *SendData,
+                                                        uint8_t *ReceiveData,
+                                                        size_t Len);
+
+/**
+ * @brief  Function type for check the transfer started by StartTransfer.
+ * @retval 
+ *         - 0: Transfer is in progress
+ *         - 1: Transfer is complete (or no transfer is started)
+ */
+typedef uint8_t (*IC74165_Platform_SPI_IsComplete_t)(void);
+
+/**
+ * @brief  Function type for check and clear the transfer error of the port.
+ * @retval 
+ *         - 0: No transfer failed since the last call
+ *         - 1: A transfer failed since the last call
+ */
+typedef uint8_t (*IC74165_Platform_SPI_GetError_t)(void);
+
+/**
+ * @brief  Function type for shift in bytes from the chain through GPIO.
+ * @param  Data: Pointer to a buffer to store data
+ * @param  Count: Number of bytes to shift in
+ * @note   Each byte must be read MSB first, exactly like the generic bit-bang
+ *         path of the library (read Qh, then pulse CLK).
+ * @note   If Data is NULL, the function must clock the bytes out and discard
+ *         them.
+ */
+typedef void (*IC74165_Platform_ShiftBytes_t)(uint8_t *Data, uint8_t Count);
+
+/**
+ * @brief  Function type for completion of an asynchronous read.
+ * @param  Result: Result of the read
+ * @param  Data: Pointer to the buffer passed to IC74165_ReadAllAsync
+ * @param  Ctx: User context
+ */
+typedef void (*IC74165_AsyncCallback_t)(IC74165_Result_t Result, uint8_t *Data,
+                                        void *Ctx);
+
+/**
+ * @brief  Function type for consume a chunk of a streaming read.
+ * @param  Data: Pointer to the bytes of the chunk
+ * @param  Pos: Position of the first byte of the chunk in chain
+ * @param  Len: Number of bytes in the chunk
+ * @param  Ctx: User context
+ * @note   Data is only valid until the function returns.
+ */
+typedef void (*IC74165_ChunkCallback_t)(const uint8_t *Data, uint16_t Pos,
+                                        uint16_t Len, void *Ctx);
+
 /**
  * @brief  Platform dependent layer data type
  * @note   It is optional to initialize this functions:
  *         - Init
  *         - DeInit
  *         - ClkInhWrite
+ *         - BusAcquire and BusRelease
+ *         - GetTick (IC74165_CONFIG_STATS or IC74165_CONFIG_CACHE only)
+ *         - ShiftBytes (GPIO only)
  * @note   If using GPIO, user must initialize this this functions before using library:
  *         - ClkWrite
  *         - ShLdWrite
  *         - QhRead
- *         - DelayUs
+ *         - DelayUs or DelayNs
+ * @note   If DelayNs is initialized, the library uses the timing profile of the
+ *         handler instead of DelayUs(1) after each edge. EdgeLatency is the
+ *         time (ns) that a GPIO write or read takes on the platform; delays that
+ *         are already covered by it are skipped.
  * @note   If using SPI, user must initialize this this functions before using library:
- *         - SendReceive
+ *         - SendReceive or SendReceiveWide
  *         - SetLevelCS
+ * @note   If SendReceiveWide is NULL, transfers longer than 255 bytes are split
+ *         into several SendReceive calls.
+ * @note   StartTransfer and IsComplete are used by IC74165_ReadAllAsync.
+ * @note   If GetError is initialized, it is checked after each shift and a
+ *         failed transfer fails the read.
  * @note   In case of using SPI, the MOSI, MISO and CS pins must be connected to SH/LD,
  *         Qh and CLK-INH pins of 74165.
  */
@@ -128,6 +321,15 @@ typedef struct IC74165_Platform_s
   // Set level of the GPIO that connected to CLK-INH PIN of 74165
   IC74165_Platform_SetLevelGPIO_t ClkInhWrite;
 
+  // Acquire/Release the bus for a whole scan (load and shift)
+  IC74165_Platform_BusAcquire_t BusAcquire;
+  IC74165_Platform_BusRelease_t BusRelease;
+
+#if (IC74165_CONFIG_STATS || IC74165_CONFIG_CACHE)
+  // Get timestamp for scan instrumentation and cache age
+  IC74165_Platform_GetTick_t GetTick;
+#endif
+
   // Platform dependent layer for SPI or GPIO
   union
   {
@@ -141,30 +343,203 @@ typedef struct IC74165_Platform_s
       IC74165_Platform_GetLevelGPIO_t QhRead;
       // Delay (us)
       IC74165_Platform_Delay_t DelayUs;
+      // Shift in whole bytes (optional). If it is not NULL, it will be used
+      // instead of calling ClkWrite, QhRead and DelayUs for each bit.
+      IC74165_Platform_ShiftBytes_t ShiftBytes;
+      // Delay (ns) (optional)
+      IC74165_Platform_DelayNs_t DelayNs;
+      // Latency of a GPIO write or read (ns)
+      uint16_t EdgeLatency;
     } GPIO;
 
     struct
     {
       // Send and Receive data through SPI
       IC74165_Platform_SPI_SendReceive_t SendReceive;
+      // Send and Receive data through SPI with a wide length (optional)
+      IC74165_Platform_SPI_SendReceiveWide_t SendReceiveWide;
+      // Start a transfer and check its completion (optional, both or none)
+      IC74165_Platform_SPI_StartTransfer_t StartTransfer;
+      IC74165_Platform_SPI_IsComplete_t IsComplete;
+      // Check and clear the transfer error of the port (optional)
+      IC74165_Platform_SPI_GetError_t GetError;
     } SPI;
   };
 } IC74165_Platform_t;
 
 
+#if (IC74165_CONFIG_STATS)
+/**
+ * @brief  Scan instrumentation data type
+ * @note   Times are in ticks of Platform.GetTick and are only updated if it is
+ *         linked.
+ */
+typedef struct IC74165_Stats_s
+{
+  // Number of scans (Read, ReadAll, ReadStream, Multi_ReadAll)
+  uint32_t Scans;
+  // Number of bytes and bits clocked out of the chain
+  uint32_t Bytes;
+  uint32_t Bits;
+
+  // Scan time
+  uint32_t MinTime;
+  uint32_t MaxTime;
+  uint64_t TotalTime;
+  uint32_t Histogram[IC74165_STATS_BUCKETS];
+
+  // Time between the start of consecutive scans (jitter = Max - Min)
+  uint32_t MinInterval;
+  uint32_t MaxInterval;
+  uint32_t LastStart;
+} IC74165_Stats_t;
+#endif
+
+#if (IC74165_CONFIG_INTEGRITY)
+/**
+ * @brief  Integrity configuration data type
+ * @note   SER of the last chip of the chain (the farthest from Qh) is tied to
+ *         Fill. Optionally some parallel inputs of the last chip are tied to
+ *         known levels (the marker); at least one of them must differ from
+ *         Fill.
+ */
+typedef struct IC74165_Integrity_s
+{
+  // Level of SER of the last chip: 0x00 (low) or 0xFF (high)
+  uint8_t Fill;
+
+  // Inputs of the last chip tied to known levels (0: no marker)
+  uint8_t MarkerMask;
+
+  // Levels of the marker inputs (only MarkerMask bits may be set)
+  uint8_t Marker;
+} IC74165_Integrity_t;
+#endif
+
 /**
  * @brief  Handler data type
  */
 typedef struct IC74165_Handler_s
 {
-  uint8_t ChainLen;
+  uint16_t ChainLen;
+
+  // Chip family and timing profile (ns). Set them before IC74165_Init.
+  IC74165_Family_t Family;
+  IC74165_Timing_t Timing;
 
   // Platform dependent layer
   IC74165_Platform_t Platform;
+
+  // Effective delays (ns) after subtracting the GPIO latency. Private.
+  IC74165_Timing_t Delay;
+
+#if (IC74165_CONFIG_STATS)
+  // Scan instrumentation. Read only.
+  IC74165_Stats_t Stats;
+#endif
+
+#if (IC74165_CONFIG_CACHE)
+  // Read-through cache. Set by IC74165_Cache_Init, counters are read only.
+  struct
+  {
+    uint8_t *Buffer;
+    uint32_t MaxAge;
+    uint32_t Stamp;
+    uint8_t Valid;
+    uint32_t Hits;
+    uint32_t Misses;
+  } Cache;
+#endif
+
+#if (IC74165_CONFIG_INTEGRITY)
+  // Integrity configuration. Set it before IC74165_Init.
+  IC74165_Integrity_t Integrity;
+#endif
+
+  // State of asynchronous read. Private.
+  struct
+  {
+    uint8_t State;
+    uint8_t LoadByte;
+    uint8_t *Data;
+    IC74165_AsyncCallback_t Callback;
+    void *Ctx;
+  } Async;
 } IC74165_Handler_t;
 
 
+/**
+ * @brief  Multi-chain handler data type
+ * @note   Several chains share CLK, SH/LD and CLK-INH pins and their Qh pins are
+ *         connected to one GPIO port. The shared pins are linked to Handler
+ *         like a single chain (QhRead is not used) and PortRead reads the Qh
+ *         pins of all chains at once.
+ */
+typedef struct IC74165_Multi_s
+{
+  // Number of chains (1 to 32)
+  uint8_t ChainCount;
+
+  // Read the GPIO port connected to Qh pins of chains
+  IC74165_Platform_GetPortGPIO_t PortRead;
+
+  // Handler of shared pins. ChainLen is the length of the longest chain.
+  IC74165_Handler_t Handler;
+} IC74165_Multi_t;
+
+
+/**
+ * @brief  Entry of a read plan
+ */
+typedef struct IC74165_PlanEntry_s
+{
+  // Position of the chip in chain
+  uint16_t Chip;
+
+  // Bits of the chip to read (same bit order as IC74165_Read)
+  uint8_t Mask;
+
+  // Bytes shifted without storing before this chip. Set by IC74165_Plan_Init.
+  uint16_t Skip;
+} IC74165_PlanEntry_t;
+
+/**
+ * @brief  Read plan data type. It is built by IC74165_Plan_Init.
+ */
+typedef struct IC74165_Plan_s
+{
+  // Entries sorted by chip, one entry per chip
+  IC74165_PlanEntry_t *Entries;
+  uint16_t EntryCount;
+
+  // Number of bytes shifted per scan (last chip + 1)
+  uint16_t Length;
+
+  // Number of bits written to the output
+  uint32_t Bits;
+} IC74165_Plan_t;
+
+
 /* Exported Macros --------------------------------------------------------------*/
+/**
+ * @brief  Minimum timing of each chip family (ns), indexed by IC74165_Family_t.
+ *         It is used by 74165.c and 74165.hpp.
+ */
+#define IC74165_FAMILY_TIMING                             \
+{                                                         \
+  /* LoadPulse, ClkHigh, ClkLow, Setup */                 \
+  {20, 20, 20, 40}, /* IC74165_FAMILY_HC */               \
+  {25, 20, 20, 45}, /* IC74165_FAMILY_HCT */              \
+  {15, 25, 25, 35}, /* IC74165_FAMILY_LS */               \
+  { 6,  5,  5, 16}, /* IC74165_FAMILY_LV */               \
+}
+
+/**
+ * @brief  Use the maximum age of the handler in IC74165_ReadCached
+ */
+#define IC74165_CACHE_MAXAGE_HANDLER  UINT32_MAX
+
+
 /**
  * @brief  Link platform dependent layer communication type
  * @param  HANDLER: Pointer to handler
@@ -203,6 +578,35 @@ typedef struct IC74165_Handler_s
   (HANDLER)->Platform.ClkInhWrite = FUNC
 
 
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_BUSACQUIRE(HANDLER, FUNC) \
+  (HANDLER)->Platform.BusAcquire = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_BUSRELEASE(HANDLER, FUNC) \
+  (HANDLER)->Platform.BusRelease = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ * @note   It is only available if IC74165_CONFIG_STATS or IC74165_CONFIG_CACHE
+ *         is enabled.
+ */
+#define IC74165_PLATFORM_LINK_GETTICK(HANDLER, FUNC) \
+  (HANDLER)->Platform.GetTick = FUNC
+
+
 /**
  * @brief  Link platform dependent layer functions to handler
  * @param  HANDLER: Pointer to handler
@@ -239,6 +643,33 @@ typedef struct IC74165_Handler_s
   (HANDLER)->Platform.GPIO.DelayUs = FUNC
 
 
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_GPIO_SHIFTBYTES(HANDLER, FUNC) \
+  (HANDLER)->Platform.GPIO.ShiftBytes = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_GPIO_DELAYNS(HANDLER, FUNC) \
+  (HANDLER)->Platform.GPIO.DelayNs = FUNC
+
+
+/**
+ * @brief  Set latency of GPIO write/read of platform dependent layer
+ * @param  HANDLER: Pointer to handler
+ * @param  NS: Latency in nanoseconds
+ */
+#define IC74165_PLATFORM_SET_GPIO_EDGELATENCY(HANDLER, NS) \
+  (HANDLER)->Platform.GPIO.EdgeLatency = NS
+
+
 /**
  * @brief  Link platform dependent layer functions to handler
  * @param  HANDLER: Pointer to handler
@@ -248,6 +679,51 @@ typedef struct IC74165_Handler_s
   (HANDLER)->Platform.SPI.SendReceive = FUNC
 
 
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_SPI_SENDRECEIVEWIDE(HANDLER, FUNC) \
+  (HANDLER)->Platform.SPI.SendReceiveWide = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_SPI_STARTTRANSFER(HANDLER, FUNC) \
+  (HANDLER)->Platform.SPI.StartTransfer = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_SPI_ISCOMPLETE(HANDLER, FUNC) \
+  (HANDLER)->Platform.SPI.IsComplete = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to handler
+ * @param  HANDLER: Pointer to handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_SPI_GETERROR(HANDLER, FUNC) \
+  (HANDLER)->Platform.SPI.GetError = FUNC
+
+
+/**
+ * @brief  Link platform dependent layer functions to multi-chain handler
+ * @param  MULTI: Pointer to multi-chain handler
+ * @param  FUNC: Function name
+ */
+#define IC74165_PLATFORM_LINK_MULTI_PORTREAD(MULTI, FUNC) \
+  (MULTI)->PortRead = FUNC
+
+
 
 /**
  ==================================================================================
@@ -259,6 +735,8 @@ typedef struct IC74165_Handler_s
  * @brief  Initialization function.
  * @param  Handler: Pointer to handler
  * @param  ChainLen: Number of chained 74165
+ * @note   The timing profile of the handler is validated against the minimum
+ *         values of Handler->Family.
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
@@ -267,6 +745,18 @@ IC74165_Result_t
 IC74165_Init(IC74165_Handler_t *Handler, uint8_t ChainLen);
 
 
+/**
+ * @brief  Initialization function for chains longer than 255 devices.
+ * @param  Handler: Pointer to handler
+ * @param  ChainLen: Number of chained 74165
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_InitWide(IC74165_Handler_t *Handler, uint16_t ChainLen);
+
+
 /**
  * @brief  De-Initialization function.
  * @param  Handler: Pointer to handler
@@ -281,20 +771,39 @@ IC74165_DeInit(IC74165_Handler_t *Handler);
 /**
  * @brief  Read chain.
  * @param  Handler: Pointer to handler
- * @note   In case of using SPI, this function will not work and you should use
- *         IC74165_ReadAll() function.
+ * @note   Only the first Pos+Count bytes of the chain are shifted.
  * @param  Data: Pointer to a buffer to store data
  * @param  Pos: Start position in chain
  * @param  Count: Number of bytes to read from chain
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
  */
 IC74165_Result_t
 IC74165_Read(IC74165_Handler_t *Handler, uint8_t *Data,
              uint8_t Pos, uint8_t Count);
 
 
+/**
+ * @brief  Read chain with wide position and count.
+ * @param  Handler: Pointer to handler
+ * @note   Only the first Pos+Count bytes of the chain are shifted.
+ * @param  Data: Pointer to a buffer to store data
+ * @param  Pos: Start position in chain
+ * @param  Count: Number of bytes to read from chain
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadWide(IC74165_Handler_t *Handler, uint8_t *Data,
+                 uint16_t Pos, uint16_t Count);
+
+
 /**
  * @brief  Read all chained devices.
  * @param  Handler: Pointer to handler
@@ -302,27 +811,280 @@ IC74165_Read(IC74165_Handler_t *Handler, uint8_t *Data,
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
  */
 IC74165_Result_t
 IC74165_ReadAll(IC74165_Handler_t *Handler, uint8_t *Data);
 
 
+/**
+ * @brief  Read all chained devices if the bus is free.
+ * @note   It returns immediately if BusAcquire reports that the bus is busy.
+ * @param  Handler: Pointer to handler
+ * @param  Data: Pointer to a buffer to store data
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: Bus is busy or an asynchronous read is in
+ *                         progress. Nothing is read.
+ */
+IC74165_Result_t
+IC74165_TryReadAll(IC74165_Handler_t *Handler, uint8_t *Data);
+
+
+/**
+ * @brief  Start reading all chained devices without waiting for it.
+ * @note   It needs StartTransfer and IsComplete of the SPI platform layer.
+ *         Otherwise the chain is read before it returns and Callback is
+ *         called from it.
+ * @note   Call IC74165_Poll until it returns IC74165_OK. Callback is called
+ *         from IC74165_Poll when the read is complete. Data must stay valid
+ *         until then.
+ * @param  Handler: Pointer to handler
+ * @param  Data: Pointer to a buffer of ChainLen bytes
+ * @param  Callback: Function to call when the read is complete (optional)
+ * @param  Ctx: User context
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_BUSY: A read is in progress or the bus is busy.
+ */
+IC74165_Result_t
+IC74165_ReadAllAsync(IC74165_Handler_t *Handler, uint8_t *Data,
+                     IC74165_AsyncCallback_t Callback, void *Ctx);
+
+
+/**
+ * @brief  Advance the asynchronous read.
+ * @param  Handler: Pointer to handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: No read is in progress (the last one is complete).
+ *         - IC74165_FAIL: The read failed. Callback is called with it.
+ *         - IC74165_BUSY: The read is in progress.
+ */
+IC74165_Result_t
+IC74165_Poll(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Check if an asynchronous read is in progress.
+ * @param  Handler: Pointer to handler
+ * @retval 
+ *         - 0: No read is in progress
+ *         - 1: A read is in progress
+ */
+uint8_t
+IC74165_IsBusy(IC74165_Handler_t *Handler);
+
+
 /**
  * @brief  Read a shift register in the chain.
- * @note   In case of using SPI, this function will not work and you should use
- *         IC74165_ReadAll() function.
+ * @note   Only the first Pos+1 bytes of the chain are shifted.
  * @param  Handler: Pointer to handler
  * @param  Data: Pointer to a buffer to store data
  * @param  Pos: The position in the chain
  * @retval IC74165_Result_t
  *         - IC74165_OK: Operation was successful.
  *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
  */
 IC74165_Result_t
 IC74165_ReadOne(IC74165_Handler_t *Handler, uint8_t *Data,
                 uint8_t Pos);
 
 
+/**
+ * @brief  Read all chained devices in chunks.
+ * @note   The chain is loaded once and shifted ChunkLen bytes at a time. After
+ *         each chunk Callback is called while CLK is idle, so the chain keeps
+ *         its state and the processing time does not corrupt the data.
+ * @param  Handler: Pointer to handler
+ * @param  Buffer: Pointer to a buffer of ChunkLen bytes
+ * @param  ChunkLen: Number of bytes passed to each Callback call
+ * @param  Callback: Function to call for each chunk
+ * @param  Ctx: User context
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadStream(IC74165_Handler_t *Handler, uint8_t *Buffer, uint16_t ChunkLen,
+                   IC74165_ChunkCallback_t Callback, void *Ctx);
+
+
+/**
+ * @brief  Build a read plan from a list of (chip, mask) entries.
+ * @note   The plan does not copy the entries. On success they are sorted by
+ *         chip in place and entries of the same chip are merged into the first
+ *         EntryCount elements, so the array belongs to the plan and must stay
+ *         valid and unmodified while the plan is in use. On failure the array
+ *         is not modified.
+ * @param  Handler: Pointer to initialized handler
+ * @param  Plan: Pointer to plan
+ * @param  Entries: Pointer to entries. Skip fields are set by this function.
+ * @param  Count: Number of entries
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful (empty list, chip out
+ *                         of chain or zero mask).
+ */
+IC74165_Result_t
+IC74165_Plan_Init(IC74165_Handler_t *Handler, IC74165_Plan_t *Plan,
+                  IC74165_PlanEntry_t *Entries, uint16_t Count);
+
+
+/**
+ * @brief  Read the bits selected by a plan.
+ * @note   The chain is loaded once and shifted only up to the last chip of the
+ *         plan. Bytes between the chips are not stored. Selected bits are
+ *         packed from bit 0 of Out[0] upward, in chip order and from bit 0 to
+ *         bit 7 of each chip.
+ * @param  Handler: Pointer to handler
+ * @param  Plan: Pointer to plan built by IC74165_Plan_Init
+ * @param  Out: Pointer to a buffer of (Plan->Bits + 7) / 8 bytes
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadPlan(IC74165_Handler_t *Handler, const IC74165_Plan_t *Plan,
+                 uint8_t *Out);
+
+
+/**
+ * @brief  Multi-chain initialization function.
+ * @note   Link shared pins to Multi->Handler and PortRead before calling it.
+ * @param  Multi: Pointer to multi-chain handler
+ * @param  ChainCount: Number of parallel chains (1 to 32)
+ * @param  ChainLen: Number of chained 74165 in the longest chain
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Multi_Init(IC74165_Multi_t *Multi, uint8_t ChainCount, uint16_t ChainLen);
+
+
+/**
+ * @brief  Multi-chain de-initialization function.
+ * @param  Multi: Pointer to multi-chain handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Multi_DeInit(IC74165_Multi_t *Multi);
+
+
+/**
+ * @brief  Read all chains with one clock sequence.
+ * @param  Multi: Pointer to multi-chain handler
+ * @param  Data: Pointer to a buffer of ChainCount * ChainLen bytes. Data of
+ *               chain n is stored at Data[n * ChainLen].
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Multi_ReadAll(IC74165_Multi_t *Multi, uint8_t *Data);
+
+
+#if (IC74165_CONFIG_STATS)
+/**
+ * @brief  Clear scan instrumentation of the handler.
+ * @note   It is called by IC74165_Init.
+ * @param  Handler: Pointer to handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ */
+IC74165_Result_t
+IC74165_Stats_Reset(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Mean scan time.
+ * @param  Handler: Pointer to handler
+ * @retval Mean scan time in ticks (0 if there is no scan)
+ */
+uint32_t
+IC74165_Stats_MeanTime(IC74165_Handler_t *Handler);
+#endif
+
+
+#if (IC74165_CONFIG_CACHE)
+/**
+ * @brief  Enable the read-through cache of the handler.
+ * @note   After it, Read and ReadOne are served from the last full snapshot
+ *         while it is younger than MaxAge. An older snapshot is refreshed with
+ *         one ReadAll. ReadAll always reads the chain and refreshes the cache.
+ * @param  Handler: Pointer to initialized handler. GetTick must be linked.
+ * @param  Buffer: Pointer to a buffer of ChainLen bytes for the snapshot
+ * @param  MaxAge: Maximum age of the snapshot (ticks of GetTick)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Cache_Init(IC74165_Handler_t *Handler, uint8_t *Buffer, uint32_t MaxAge);
+
+
+/**
+ * @brief  Drop the cached snapshot. The next read refreshes it.
+ * @param  Handler: Pointer to handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ */
+IC74165_Result_t
+IC74165_Cache_Invalidate(IC74165_Handler_t *Handler);
+
+
+/**
+ * @brief  Read chain through the cache with a maximum age for this call.
+ * @param  Handler: Pointer to handler
+ * @param  Data: Pointer to a buffer to store data
+ * @param  Pos: Start position in chain
+ * @param  Count: Number of bytes to read from chain
+ * @param  MaxAge: Maximum age of the snapshot (ticks of GetTick), or
+ *                 IC74165_CACHE_MAXAGE_HANDLER to use the one of the handler
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_ReadCached(IC74165_Handler_t *Handler, uint8_t *Data,
+                   uint16_t Pos, uint16_t Count, uint32_t MaxAge);
+#endif
+
+
+#if (IC74165_CONFIG_INTEGRITY)
+/**
+ * @brief  Find the physical chain length.
+ * @note   The chain is loaded and shifted MaxLen + 1 bytes. The bytes after
+ *         the last chip are the SER fill of Handler->Integrity, so the chain
+ *         ends at the last byte that differs from it. Without a marker, a last
+ *         chip whose inputs all equal the fill is not counted.
+ * @param  Handler: Pointer to initialized handler (any ChainLen)
+ * @param  MaxLen: Maximum number of chained 74165
+ * @param  ChainLen: Pointer to store the length. Pass it to IC74165_InitWide.
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful (no chip found or the
+ *                         chain is longer than MaxLen).
+ *         - IC74165_CORRUPT: The marker is not found in the last chip.
+ *         - IC74165_BUSY: An asynchronous read is in progress.
+ */
+IC74165_Result_t
+IC74165_Probe(IC74165_Handler_t *Handler, uint16_t MaxLen, uint16_t *ChainLen);
+#endif
+
+
 
 #ifdef __cplusplus
 }
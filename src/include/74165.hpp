@@ -0,0 +1,330 @@
+/**
+ **********************************************************************************
+ * @file   74165.hpp
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Header-only C++17 front-end for 74165 chip driver
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef __74165_HPP__
+#define __74165_HPP__
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <type_traits>
+#include "74165.h"
+
+
+/**
+ ==================================================================================
+                           ##### Port Policy Traits #####                          
+ ==================================================================================
+ */
+
+/**
+ * @brief  Port policy detection helpers.
+ * @note   A port policy is a type with static inline functions. It must provide:
+ *         - static void    ClkWrite(uint8_t Level)
+ *         - static void    ShLdWrite(uint8_t Level)
+ *         - static uint8_t QhRead(void)
+ *         - static void    DelayUs(uint8_t Delay) or
+ *           static void    DelayNs(uint16_t Delay)
+ * @note   It is optional to provide this functions and constants:
+ *         - static void    Init(void)
+ *         - static void    DeInit(void)
+ *         - static void    ClkInhWrite(uint8_t Level)
+ *         - static constexpr IC74165_Family_t Family (default: HC)
+ *         - static constexpr IC74165_Timing_t Timing (default: family minimum)
+ *         - static constexpr uint16_t EdgeLatency (ns, default: 0)
+ * @note   With DelayNs, the delays follow the timing profile exactly like
+ *         IC74165_Init computes them for the C driver, at compile time. With
+ *         DelayUs only, each delay is DelayUs(1).
+ */
+namespace IC74165_Detail
+{
+template <typename Port, typename = void>
+struct HasInit : std::false_type {};
+template <typename Port>
+struct HasInit<Port, std::void_t<decltype(Port::Init())>> : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasDeInit : std::false_type {};
+template <typename Port>
+struct HasDeInit<Port, std::void_t<decltype(Port::DeInit())>> : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasClkInhWrite : std::false_type {};
+template <typename Port>
+struct HasClkInhWrite<Port, std::void_t<decltype(Port::ClkInhWrite(uint8_t{}))>>
+  : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasDelayUs : std::false_type {};
+template <typename Port>
+struct HasDelayUs<Port, std::void_t<decltype(Port::DelayUs(uint8_t{}))>>
+  : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasDelayNs : std::false_type {};
+template <typename Port>
+struct HasDelayNs<Port, std::void_t<decltype(Port::DelayNs(uint16_t{}))>>
+  : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasFamily : std::false_type {};
+template <typename Port>
+struct HasFamily<Port, std::void_t<decltype(Port::Family)>> : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasTiming : std::false_type {};
+template <typename Port>
+struct HasTiming<Port, std::void_t<decltype(Port::Timing)>> : std::true_type {};
+
+template <typename Port, typename = void>
+struct HasEdgeLatency : std::false_type {};
+template <typename Port>
+struct HasEdgeLatency<Port, std::void_t<decltype(Port::EdgeLatency)>>
+  : std::true_type {};
+
+inline constexpr IC74165_Timing_t FamilyTiming[] = IC74165_FAMILY_TIMING;
+
+template <typename Port>
+constexpr IC74165_Family_t FamilyOf(void)
+{
+  if constexpr (HasFamily<Port>::value)
+    return Port::Family;
+  else
+    return IC74165_FAMILY_HC;
+}
+
+template <typename Port>
+constexpr IC74165_Timing_t TimingOf(void)
+{
+  if constexpr (HasTiming<Port>::value)
+    return Port::Timing;
+  else
+    return IC74165_Timing_t{0, 0, 0, 0};
+}
+
+template <typename Port>
+constexpr uint16_t EdgeLatencyOf(void)
+{
+  if constexpr (HasEdgeLatency<Port>::value)
+    return Port::EdgeLatency;
+  else
+    return 0;
+}
+
+/**
+ * @brief  Same rules as IC74165_TimingSelect in 74165.c: zero means the family
+ *         minimum, and the GPIO latency is already part of each delay.
+ */
+constexpr uint16_t
+TimingSelect(uint16_t Value, uint16_t Min, uint16_t Latency)
+{
+  if (Value == 0)
+    Value = Min;
+  return (Value > Latency) ? (Value - Latency) : 0;
+}
+
+constexpr bool
+TimingValid(uint16_t Value, uint16_t Min)
+{
+  return Value == 0 || Value >= Min;
+}
+} // namespace IC74165_Detail
+
+
+
+/**
+ ==================================================================================
+                               ##### Class #####                                   
+ ==================================================================================
+ */
+
+/**
+ * @brief  74165 chain with compile-time port and chain length.
+ * @note   All port functions are called statically, so the compiler can inline
+ *         and unroll the whole scan loop. The C API in 74165.h is not affected.
+ * @tparam Port: Port policy type
+ * @tparam ChainLen: Number of chained 74165
+ */
+template <typename Port, size_t ChainLen>
+class IC74165
+{
+  static_assert(ChainLen > 0, "ChainLen must be at least 1");
+  static_assert(IC74165_Detail::HasDelayUs<Port>::value ||
+                IC74165_Detail::HasDelayNs<Port>::value,
+                "Port must provide DelayUs or DelayNs");
+
+  static constexpr IC74165_Family_t Family = IC74165_Detail::FamilyOf<Port>();
+  static_assert((size_t)Family < sizeof(IC74165_Detail::FamilyTiming) /
+                                 sizeof(IC74165_Detail::FamilyTiming[0]),
+                "Unknown chip family");
+
+  static constexpr IC74165_Timing_t Min = IC74165_Detail::FamilyTiming[Family];
+  static constexpr IC74165_Timing_t Timing = IC74165_Detail::TimingOf<Port>();
+  static constexpr uint16_t Latency = IC74165_Detail::EdgeLatencyOf<Port>();
+
+  static_assert(IC74165_Detail::TimingValid(Timing.LoadPulse, Min.LoadPulse) &&
+                IC74165_Detail::TimingValid(Timing.ClkHigh, Min.ClkHigh) &&
+                IC74165_Detail::TimingValid(Timing.ClkLow, Min.ClkLow) &&
+                IC74165_Detail::TimingValid(Timing.Setup, Min.Setup),
+                "Timing profile is faster than the chip family allows");
+
+  // Effective delays (ns), computed like IC74165_Init does
+  static constexpr uint16_t LoadPulseNs =
+      IC74165_Detail::TimingSelect(Timing.LoadPulse, Min.LoadPulse, Latency);
+  static constexpr uint16_t ClkHighNs =
+      IC74165_Detail::TimingSelect(Timing.ClkHigh, Min.ClkHigh, Latency);
+  static constexpr uint16_t SetupNs =
+      IC74165_Detail::TimingSelect(Timing.Setup, Min.Setup, Latency);
+  // Qh is sampled right after the CLK low phase
+  static constexpr uint16_t ClkLowNs =
+      (IC74165_Detail::TimingSelect(Timing.ClkLow, Min.ClkLow, Latency) > SetupNs)
+          ? IC74165_Detail::TimingSelect(Timing.ClkLow, Min.ClkLow, Latency)
+          : SetupNs;
+
+public:
+  using Data_t = std::array<uint8_t, ChainLen>;
+
+  /**
+   * @brief  Initialization function.
+   */
+  static void Init(void)
+  {
+    if constexpr (IC74165_Detail::HasInit<Port>::value)
+      Port::Init();
+  }
+
+  /**
+   * @brief  De-Initialization function.
+   */
+  static void DeInit(void)
+  {
+    if constexpr (IC74165_Detail::HasDeInit<Port>::value)
+      Port::DeInit();
+  }
+
+  /**
+   * @brief  Read all chained devices.
+   * @retval Data of all chained devices
+   */
+  static Data_t ReadAll(void)
+  {
+    Data_t Data;
+    Load();
+    ShiftIn<0>(Data.data(), ChainLen);
+    return Data;
+  }
+
+  /**
+   * @brief  Read chain.
+   * @tparam Pos: Start position in chain
+   * @tparam Count: Number of bytes to read from chain
+   * @retval Data of the selected devices
+   */
+  template <size_t Pos, size_t Count>
+  static std::array<uint8_t, Count> Read(void)
+  {
+    static_assert(Count > 0, "Count must be at least 1");
+    static_assert(Pos + Count <= ChainLen, "Read out of chain range");
+
+    std::array<uint8_t, Count> Data;
+    Load();
+    ShiftIn<Pos>(Data.data(), Count);
+    return Data;
+  }
+
+  /**
+   * @brief  Read a shift register in the chain.
+   * @tparam Pos: The position in the chain
+   * @retval Data of the selected device
+   */
+  template <size_t Pos>
+  static uint8_t ReadOne(void)
+  {
+    return Read<Pos, 1>()[0];
+  }
+
+private:
+  template <uint16_t Ns>
+  static inline void Delay(void)
+  {
+    if constexpr (IC74165_Detail::HasDelayNs<Port>::value)
+    {
+      if constexpr (Ns != 0)
+        Port::DelayNs(Ns);
+    }
+    else
+    {
+      Port::DelayUs(1);
+    }
+  }
+
+  static inline void Load(void)
+  {
+    Port::ShLdWrite(0);
+    Delay<LoadPulseNs>();
+    Port::ShLdWrite(1);
+    Delay<SetupNs>();
+  }
+
+  static inline uint8_t ShiftByte(void)
+  {
+    uint8_t Buffer = 0;
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      Buffer |= (Port::QhRead() << j);
+      Port::ClkWrite(1);
+      Delay<ClkHighNs>();
+      Port::ClkWrite(0);
+      Delay<ClkLowNs>();
+    }
+    return Buffer;
+  }
+
+  template <size_t Skip>
+  static inline void ShiftIn(uint8_t *Data, size_t Count)
+  {
+    if constexpr (IC74165_Detail::HasClkInhWrite<Port>::value)
+      Port::ClkInhWrite(0);
+
+    for (size_t i = 0; i < Skip; i++)
+      (void)ShiftByte();
+
+    for (size_t i = 0; i < Count; i++)
+      Data[i] = ShiftByte();
+
+    if constexpr (IC74165_Detail::HasClkInhWrite<Port>::value)
+      Port::ClkInhWrite(1);
+  }
+};
+
+
+#endif //! __74165_HPP__
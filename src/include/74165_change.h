@@ -0,0 +1,178 @@
+/**
+ **********************************************************************************
+ * @file   74165_change.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Change detection over consecutive 74165 chain scans
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef __74165_CHANGE_H__
+#define __74165_CHANGE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdint.h>
+#include "74165.h"
+
+
+/* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Width of the words used to compare snapshots
+ *         - 0: 32-bit words
+ *         - 1: 64-bit words
+ */
+#ifndef IC74165_CHANGE_WORD_64
+#define IC74165_CHANGE_WORD_64  0
+#endif
+
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+#if (IC74165_CHANGE_WORD_64)
+typedef uint64_t IC74165_ChangeWord_t;
+#else
+typedef uint32_t IC74165_ChangeWord_t;
+#endif
+
+/**
+ * @brief  Function type for edge event.
+ * @param  Ctx: User context
+ * @param  Bit: Bit index in chain (Byte * 8 + Bit of byte)
+ * @param  Level: New level of the input
+ *         - 0: Falling edge
+ *         - 1: Rising edge
+ */
+typedef void (*IC74165_Change_Callback_t)(void *Ctx, uint32_t Bit, uint8_t Level);
+
+/**
+ * @brief  Change tracker data type
+ */
+typedef struct IC74165_Change_s
+{
+  IC74165_Handler_t *Handler;
+
+  // Edge callback (optional)
+  IC74165_Change_Callback_t Callback;
+  void *Ctx;
+
+  // Private
+  uint8_t *Prev;
+  uint8_t *Curr;
+  uint16_t Len;
+  uint8_t Valid;
+} IC74165_Change_t;
+
+/**
+ * @brief  Edge iterator data type
+ */
+typedef struct IC74165_ChangeIter_s
+{
+  uint32_t Offset;
+  IC74165_ChangeWord_t Pending;
+} IC74165_ChangeIter_t;
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize change tracker.
+ * @param  Change: Pointer to change tracker
+ * @param  Handler: Pointer to initialized handler
+ * @param  Buffer: Pointer to a buffer of 2 * ChainLen bytes for snapshots
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Change_Init(IC74165_Change_t *Change, IC74165_Handler_t *Handler,
+                    uint8_t *Buffer);
+
+
+/**
+ * @brief  Read all chained devices and compare them with the previous scan.
+ * @param  Change: Pointer to change tracker
+ * @param  Changed: Pointer to store the result (can be NULL)
+ *         - 0: Nothing changed (always 0 for the first scan)
+ *         - 1: At least one input changed
+ * @note   If Callback is set, it will be called for each edge.
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Change_Scan(IC74165_Change_t *Change, uint8_t *Changed);
+
+
+/**
+ * @brief  Get the last snapshot.
+ * @param  Change: Pointer to change tracker
+ * @retval Pointer to ChainLen bytes of the last scan
+ */
+const uint8_t *
+IC74165_Change_Data(IC74165_Change_t *Change);
+
+
+/**
+ * @brief  Start iterating over the edges of the last scan.
+ * @param  Change: Pointer to change tracker
+ * @param  Iter: Pointer to iterator
+ * @retval None
+ */
+void
+IC74165_Change_IterInit(IC74165_Change_t *Change, IC74165_ChangeIter_t *Iter);
+
+
+/**
+ * @brief  Get the next edge of the last scan.
+ * @param  Change: Pointer to change tracker
+ * @param  Iter: Pointer to iterator
+ * @param  Bit: Pointer to store bit index in chain (Byte * 8 + Bit of byte)
+ * @param  Level: Pointer to store new level of the input (can be NULL)
+ * @retval 
+ *         - 0: No more edges
+ *         - 1: An edge is stored in Bit and Level
+ */
+uint8_t
+IC74165_Change_IterNext(IC74165_Change_t *Change, IC74165_ChangeIter_t *Iter,
+                        uint32_t *Bit, uint8_t *Level);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //! __74165_CHANGE_H__
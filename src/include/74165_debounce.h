@@ -0,0 +1,149 @@
+/**
+ **********************************************************************************
+ * @file   74165_debounce.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Bit-parallel debouncer for 74165 chain inputs
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef __74165_DEBOUNCE_H__
+#define __74165_DEBOUNCE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdint.h>
+#include "74165.h"
+
+
+/* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Number of bits of the vertical counters. The maximum debounce depth
+ *         is (2^IC74165_DEBOUNCE_COUNTER_BITS - 1) scans.
+ */
+#ifndef IC74165_DEBOUNCE_COUNTER_BITS
+#define IC74165_DEBOUNCE_COUNTER_BITS 4
+#endif
+
+
+
+/* Exported Macros --------------------------------------------------------------*/
+/**
+ * @brief  Size of the buffer needed by the debouncer
+ * @param  LEN: Number of bytes of inputs (chain length)
+ */
+#define IC74165_DEBOUNCE_BUFFER_SIZE(LEN) \
+  ((2 + IC74165_DEBOUNCE_COUNTER_BITS) * (LEN))
+
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  Debouncer data type
+ */
+typedef struct IC74165_Debounce_s
+{
+  // Private
+  IC74165_Handler_t *Handler;
+  uint8_t *State;
+  uint8_t *Sample;
+  uint8_t *Counter;
+  uint16_t Len;
+  uint8_t Depth;
+  uint8_t Valid;
+} IC74165_Debounce_t;
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize debouncer.
+ * @param  Debounce: Pointer to debouncer
+ * @param  Handler: Pointer to initialized handler for IC74165_Debounce_Scan
+ *                  (can be NULL if only IC74165_Debounce_Update is used)
+ * @param  Len: Number of bytes of inputs (chain length)
+ * @param  Depth: Number of consecutive equal samples to accept a new level
+ * @param  Buffer: Pointer to a buffer of IC74165_DEBOUNCE_BUFFER_SIZE(Len) bytes
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Debounce_Init(IC74165_Debounce_t *Debounce, IC74165_Handler_t *Handler,
+                      uint16_t Len, uint8_t Depth, uint8_t *Buffer);
+
+
+/**
+ * @brief  Feed a new snapshot to the debouncer.
+ * @param  Debounce: Pointer to debouncer
+ * @param  Sample: Pointer to Len bytes of raw inputs (e.g. from IC74165_ReadAll)
+ * @param  Changed: Pointer to store the result (can be NULL)
+ *         - 0: No debounced input changed
+ *         - 1: At least one debounced input changed
+ * @retval None
+ */
+void
+IC74165_Debounce_Update(IC74165_Debounce_t *Debounce, const uint8_t *Sample,
+                        uint8_t *Changed);
+
+
+/**
+ * @brief  Read all chained devices through the handler given to
+ *         IC74165_Debounce_Init and feed them to the debouncer.
+ * @param  Debounce: Pointer to debouncer
+ * @param  Changed: Pointer to store the result (can be NULL)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Debounce_Scan(IC74165_Debounce_t *Debounce, uint8_t *Changed);
+
+
+/**
+ * @brief  Get the debounced inputs.
+ * @param  Debounce: Pointer to debouncer
+ * @retval Pointer to Len bytes of debounced inputs
+ */
+const uint8_t *
+IC74165_Debounce_Data(IC74165_Debounce_t *Debounce);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //! __74165_DEBOUNCE_H__
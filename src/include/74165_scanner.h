@@ -0,0 +1,166 @@
+/**
+ **********************************************************************************
+ * @file   74165_scanner.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Periodic 74165 chain scanner with lock-free snapshot
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef __74165_SCANNER_H__
+#define __74165_SCANNER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdint.h>
+#include "74165.h"
+
+
+/* Functionality Options --------------------------------------------------------*/
+/**
+ * @brief  Full memory barrier between the scanner and the readers
+ */
+#ifndef IC74165_SCANNER_BARRIER
+#if defined(__GNUC__)
+#define IC74165_SCANNER_BARRIER() __sync_synchronize()
+#else
+#error "Define IC74165_SCANNER_BARRIER() for this compiler"
+#endif
+#endif
+
+
+
+/* Exported Macros --------------------------------------------------------------*/
+/**
+ * @brief  Size of the buffer needed by the scanner
+ * @param  LEN: Chain length
+ */
+#define IC74165_SCANNER_BUFFER_SIZE(LEN) (2 * (LEN))
+
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+
+/**
+ * @brief  Scanner data type
+ * @note   The scanner owns the handler. Only the task or timer that calls
+ *         IC74165_Scanner_Poll/IC74165_Scanner_Scan may use the handler.
+ */
+typedef struct IC74165_Scanner_s
+{
+  IC74165_Handler_t *Handler;
+
+  // Scan period (in the unit of Now passed to IC74165_Scanner_Poll)
+  uint32_t Period;
+
+  // Private
+  uint8_t *Buffer;
+  uint16_t Len;
+  volatile uint32_t Seq;
+  volatile uint32_t Timestamp[2];
+  uint32_t LastScan;
+  uint8_t Started;
+} IC74165_Scanner_t;
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+/**
+ * @brief  Initialize scanner.
+ * @param  Scanner: Pointer to scanner
+ * @param  Handler: Pointer to initialized handler
+ * @param  Period: Scan period (in the unit of Now passed to IC74165_Scanner_Poll)
+ * @param  Buffer: Pointer to a buffer of IC74165_SCANNER_BUFFER_SIZE(ChainLen)
+ *                 bytes
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ */
+IC74165_Result_t
+IC74165_Scanner_Init(IC74165_Scanner_t *Scanner, IC74165_Handler_t *Handler,
+                     uint32_t Period, uint8_t *Buffer);
+
+
+/**
+ * @brief  Scan the chain and publish the result.
+ * @note   Call it from a periodic timer or task. If the read fails, nothing is
+ *         published and readers keep the last snapshot.
+ * @param  Scanner: Pointer to scanner
+ * @param  Now: Current time. It will be stored as the snapshot timestamp.
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Scanner_Scan(IC74165_Scanner_t *Scanner, uint32_t Now);
+
+
+/**
+ * @brief  Scan the chain if the scan period is elapsed.
+ * @note   Call it from a task loop faster than the scan period.
+ * @param  Scanner: Pointer to scanner
+ * @param  Now: Current time
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: Operation was not successful.
+ *         - IC74165_CORRUPT: Integrity check failed (IC74165_CONFIG_INTEGRITY).
+ */
+IC74165_Result_t
+IC74165_Scanner_Poll(IC74165_Scanner_t *Scanner, uint32_t Now);
+
+
+/**
+ * @brief  Get a consistent copy of the last published snapshot.
+ * @note   It can be called from any number of tasks at the same time. It does
+ *         not use any lock and does not touch the bus.
+ * @param  Scanner: Pointer to scanner
+ * @param  Data: Pointer to a buffer of ChainLen bytes
+ * @param  Generation: Pointer to store number of published scans (can be NULL).
+ *                     It skips 0 when it wraps.
+ * @param  Timestamp: Pointer to store time of the snapshot (can be NULL)
+ * @retval IC74165_Result_t
+ *         - IC74165_OK: Operation was successful.
+ *         - IC74165_FAIL: No snapshot is published yet.
+ */
+IC74165_Result_t
+IC74165_Scanner_Get(IC74165_Scanner_t *Scanner, uint8_t *Data,
+                    uint32_t *Generation, uint32_t *Timestamp);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //! __74165_SCANNER_H__
@@ -0,0 +1,196 @@
+/**
+ **********************************************************************************
+ * @file   avr_test.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Host tests of the ATmega32 port on stubbed avr-libc headers
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <string.h>
+#include "74165.h"
+#include "74165_platform.h"
+#include "avr_stub.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define TEST_LEN  12
+
+// Duration of one CPU cycle (ns)
+#define TEST_CYCLE_NS  (1000000000UL / IC74165_AVR_CLK)
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+static uint8_t Inputs[TEST_LEN];
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+SetInputs(uint8_t Seed)
+{
+  for (uint16_t i = 0; i < TEST_LEN; i++)
+  {
+    Inputs[i] = (uint8_t)(Seed + i * 53);
+    AvrStub_SetInputs(i, Inputs[i]);
+  }
+}
+
+static void
+Test_GPIO(void)
+{
+  IC74165_Handler_t Handler = {0};
+  uint8_t Data[TEST_LEN];
+
+  AvrStub_Reset();
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(1);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  SetInputs(2);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 5, 4) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[5], 4) == 0);
+
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  ShiftBytes holds each CLK phase for the handler's profile, net of
+ *         the two-cycle pin write.
+ */
+static void
+Test_Timing(void)
+{
+  const IC74165_Timing_t Slow = {0, 2000, 4000, 0};
+  IC74165_Handler_t Handler = {0};
+  AvrStub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  AvrStub_Reset();
+  Handler.Timing = Slow;
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(3);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  AvrStub_GetStats(&Stats);
+  TEST_CHECK(Stats.MinClkHighCycles >=
+             (2000 - 2 * TEST_CYCLE_NS + TEST_CYCLE_NS - 1) / TEST_CYCLE_NS);
+  TEST_CHECK(Stats.MinClkLowCycles >=
+             (4000 - 2 * TEST_CYCLE_NS + TEST_CYCLE_NS - 1) / TEST_CYCLE_NS);
+  IC74165_DeInit(&Handler);
+}
+
+static void
+Test_SPI(void)
+{
+  IC74165_Handler_t Handler = {0};
+  AvrStub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  AvrStub_Reset();
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(4);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  SetInputs(5);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 2, 7) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[2], 7) == 0);
+
+  // Blocking reads poll SPIF and never take the interrupt
+  AvrStub_GetStats(&Stats);
+  TEST_CHECK(Stats.Irqs == 0);
+  TEST_CHECK(Stats.ClkInh == IC74165_CLKINH_ENABLE);
+  IC74165_DeInit(&Handler);
+}
+
+#if (IC74165_SPI_USE_ISR)
+/**
+ * @brief  The bytes of the scan are shifted from the SPI interrupt while the
+ *         caller polls.
+ */
+static void
+Test_Async(void)
+{
+  IC74165_Handler_t Handler = {0};
+  AvrStub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+  uint32_t Polls = 0;
+
+  AvrStub_Reset();
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(6);
+  TEST_CHECK(IC74165_ReadAllAsync(&Handler, Data, NULL, NULL) == IC74165_OK);
+  while (IC74165_Poll(&Handler) == IC74165_BUSY && Polls < 100)
+  {
+    Polls++;
+    AvrStub_Irq();
+  }
+  TEST_CHECK(Polls > 0 && Polls < 100);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  // One interrupt for the load byte and one per chip
+  AvrStub_GetStats(&Stats);
+  TEST_CHECK(Stats.Irqs == TEST_LEN + 1);
+  TEST_CHECK(Stats.ClkInh == 1);
+  IC74165_DeInit(&Handler);
+}
+#endif
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  Test_GPIO();
+  Test_Timing();
+  Test_SPI();
+#if (IC74165_SPI_USE_ISR)
+  Test_Async();
+#endif
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,115 @@
+/**
+ **********************************************************************************
+ * @file   chain_stub.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Inline 74165 chain model for host benchmarks
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _CHAIN_STUB_H_
+#define _CHAIN_STUB_H_
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/* Exported Constants -----------------------------------------------------------*/
+#define CHAIN_STUB_MAX_CHIPS 1024
+
+
+/* Exported Variables -----------------------------------------------------------*/
+/**
+ * @brief  Pin state of the model. Unlike port/Host-Sim it keeps no time or
+ *         counters, so a pin access costs a few instructions and the benchmark
+ *         measures the driver itself.
+ */
+static struct
+{
+  uint8_t Inputs[CHAIN_STUB_MAX_CHIPS];
+  uint8_t ShLd;
+  uint8_t Clk;
+  uint8_t ClkInh;
+  // Number of bits shifted out since the last load
+  uint32_t Pos;
+} ChainStub = {{0}, 1, 0, 0, 0};
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+/**
+ * @brief  The register is not copied on load. Qh is taken from the parallel
+ *         inputs at the current shift position and SER is tied low.
+ */
+static inline uint8_t
+ChainStub_QhRead(void)
+{
+  uint32_t Chip = ChainStub.Pos >> 3;
+
+  if (Chip >= CHAIN_STUB_MAX_CHIPS)
+    return 0;
+  return (ChainStub.Inputs[Chip] >> (7 - (ChainStub.Pos & 7))) & 1;
+}
+
+/**
+ * @brief  The internal clock of 74165 is CLK OR CLK-INH.
+ */
+static inline void
+ChainStub_ClkWrite(uint8_t Level)
+{
+  if (!(ChainStub.Clk | ChainStub.ClkInh) && Level && ChainStub.ShLd)
+    ChainStub.Pos++;
+  ChainStub.Clk = Level;
+}
+
+static inline void
+ChainStub_ClkInhWrite(uint8_t Level)
+{
+  if (!(ChainStub.Clk | ChainStub.ClkInh) && Level && ChainStub.ShLd)
+    ChainStub.Pos++;
+  ChainStub.ClkInh = Level;
+}
+
+static inline void
+ChainStub_ShLdWrite(uint8_t Level)
+{
+  if (!Level)
+    ChainStub.Pos = 0;
+  ChainStub.ShLd = Level;
+}
+
+static inline void
+ChainStub_DelayNs(uint16_t Delay)
+{
+  (void)Delay;
+}
+
+
+#endif //! _CHAIN_STUB_H_
@@ -0,0 +1,128 @@
+/**
+ **********************************************************************************
+ * @file   debounce_bench.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Benchmark of the debouncer against per-bit counters
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "74165.h"
+#include "74165_debounce.h"
+#include "debounce_ref.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define BENCH_SAMPLES 64
+#define BENCH_ROUNDS  20000
+#define BENCH_DEPTH   4
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static double
+NowNs(void)
+{
+  struct timespec Ts;
+  clock_gettime(CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+/**
+ * @brief  Time one update of both debouncers with Len bytes of bouncing inputs.
+ * @retval 0 if both gave the same result, 1 otherwise
+ */
+static int
+Bench(uint16_t Len)
+{
+  static DebounceRef_t Ref;
+  static uint8_t Samples[BENCH_SAMPLES][DEBOUNCE_REF_MAX_LEN];
+  static uint8_t Buffer[IC74165_DEBOUNCE_BUFFER_SIZE(DEBOUNCE_REF_MAX_LEN)];
+  IC74165_Debounce_t Debounce;
+  uint32_t Sum = 0;
+  double Start, TimeVertical, TimeRef;
+
+  // A quarter of the bytes bounce in every sample
+  for (int s = 0; s < BENCH_SAMPLES; s++)
+    for (uint16_t i = 0; i < Len; i++)
+      Samples[s][i] = (rand() % 4 == 0) ? (uint8_t)rand() : 0x00;
+
+  IC74165_Debounce_Init(&Debounce, NULL, Len, BENCH_DEPTH, Buffer);
+  DebounceRef_Init(&Ref, Len, BENCH_DEPTH);
+
+  Start = NowNs();
+  for (int r = 0; r < BENCH_ROUNDS; r++)
+  {
+    uint8_t Changed;
+    IC74165_Debounce_Update(&Debounce, Samples[r % BENCH_SAMPLES], &Changed);
+    Sum += Changed;
+  }
+  TimeVertical = (NowNs() - Start) / BENCH_ROUNDS;
+
+  Start = NowNs();
+  for (int r = 0; r < BENCH_ROUNDS; r++)
+    Sum += DebounceRef_Update(&Ref, Samples[r % BENCH_SAMPLES]);
+  TimeRef = (NowNs() - Start) / BENCH_ROUNDS;
+
+  printf("%4u bytes: vertical %9.1f ns  per-bit %9.1f ns  speedup %5.2fx  "
+         "(sum %u)\n", (unsigned)Len, TimeVertical, TimeRef,
+         TimeRef / TimeVertical, (unsigned)Sum);
+
+  if (memcmp(IC74165_Debounce_Data(&Debounce), Ref.State, Len) != 0)
+  {
+    printf("%4u bytes: result differs from the reference\n", (unsigned)Len);
+    return 1;
+  }
+  return 0;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  int Fail = 0;
+
+  srand(1);
+  Fail |= Bench(8);
+  Fail |= Bench(64);
+  Fail |= Bench(512);
+
+  return Fail;
+}
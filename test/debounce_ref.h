@@ -0,0 +1,114 @@
+/**
+ **********************************************************************************
+ * @file   debounce_ref.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Per-bit reference debouncer for host tests and benchmarks
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _DEBOUNCE_REF_H_
+#define _DEBOUNCE_REF_H_
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+
+/* Exported Constants -----------------------------------------------------------*/
+#define DEBOUNCE_REF_MAX_LEN 512
+
+
+/* Exported Data Types ----------------------------------------------------------*/
+/**
+ * @brief  One counter per input, as application code usually does it.
+ */
+typedef struct DebounceRef_s
+{
+  uint8_t State[DEBOUNCE_REF_MAX_LEN];
+  uint8_t Count[DEBOUNCE_REF_MAX_LEN * 8];
+  uint16_t Len;
+  uint8_t Depth;
+  uint8_t Valid;
+} DebounceRef_t;
+
+
+
+/**
+ ==================================================================================
+                               ##### Functions #####                               
+ ==================================================================================
+ */
+
+static inline void
+DebounceRef_Init(DebounceRef_t *Ref, uint16_t Len, uint8_t Depth)
+{
+  memset(Ref, 0, sizeof(*Ref));
+  Ref->Len = Len;
+  Ref->Depth = Depth;
+}
+
+/**
+ * @brief  An input takes a new level after Depth consecutive samples that
+ *         differ from its debounced level. The first sample is taken as is.
+ * @retval 1 if a debounced input changed, 0 otherwise
+ */
+static inline uint8_t
+DebounceRef_Update(DebounceRef_t *Ref, const uint8_t *Sample)
+{
+  uint8_t Changed = 0;
+
+  if (!Ref->Valid)
+  {
+    memcpy(Ref->State, Sample, Ref->Len);
+    Ref->Valid = 1;
+    return 0;
+  }
+
+  for (uint32_t Bit = 0; Bit < Ref->Len * 8U; Bit++)
+  {
+    uint8_t Mask = (uint8_t)(1U << (Bit & 7));
+    uint8_t *State = &Ref->State[Bit >> 3];
+
+    if ((Sample[Bit >> 3] ^ *State) & Mask)
+    {
+      if (++Ref->Count[Bit] >= Ref->Depth)
+      {
+        *State ^= Mask;
+        Ref->Count[Bit] = 0;
+        Changed = 1;
+      }
+    }
+    else
+    {
+      Ref->Count[Bit] = 0;
+    }
+  }
+
+  return Changed;
+}
+
+
+#endif //! _DEBOUNCE_REF_H_
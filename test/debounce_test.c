@@ -0,0 +1,188 @@
+/**
+ **********************************************************************************
+ * @file   debounce_test.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Host tests of the debouncer
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "74165.h"
+#include "74165_debounce.h"
+#include "74165_platform.h"
+#include "debounce_ref.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define TEST_LEN    5
+#define TEST_SCANS  2000
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+Test_Init(void)
+{
+  IC74165_Debounce_t Debounce;
+  IC74165_Handler_t Handler = {0};
+  uint8_t Buffer[IC74165_DEBOUNCE_BUFFER_SIZE(TEST_LEN)];
+  uint8_t Changed;
+
+  TEST_CHECK(IC74165_Debounce_Init(&Debounce, NULL, TEST_LEN, 0, Buffer) ==
+             IC74165_FAIL);
+  TEST_CHECK(IC74165_Debounce_Init(&Debounce, NULL, TEST_LEN,
+                                   1U << IC74165_DEBOUNCE_COUNTER_BITS,
+                                   Buffer) == IC74165_FAIL);
+  TEST_CHECK(IC74165_Debounce_Init(&Debounce, NULL, TEST_LEN, 3, NULL) ==
+             IC74165_FAIL);
+
+  // Scan needs a handler of the same length
+  TEST_CHECK(IC74165_Debounce_Init(&Debounce, NULL, TEST_LEN, 3, Buffer) ==
+             IC74165_OK);
+  TEST_CHECK(IC74165_Debounce_Scan(&Debounce, &Changed) == IC74165_FAIL);
+
+  IC74165_Sim_Reset(TEST_LEN + 1);
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN + 1) == IC74165_OK);
+  TEST_CHECK(IC74165_Debounce_Init(&Debounce, &Handler, TEST_LEN, 3, Buffer) ==
+             IC74165_FAIL);
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  Feed random bouncing samples to both debouncers for every depth.
+ */
+static void
+Test_Reference(void)
+{
+  static DebounceRef_t Ref;
+  IC74165_Debounce_t Debounce;
+  uint8_t Buffer[IC74165_DEBOUNCE_BUFFER_SIZE(TEST_LEN)];
+  uint8_t Level[TEST_LEN] = {0};
+  uint8_t Sample[TEST_LEN];
+
+  srand(1);
+  for (uint8_t Depth = 1; Depth < (1U << IC74165_DEBOUNCE_COUNTER_BITS); Depth++)
+  {
+    TEST_CHECK(IC74165_Debounce_Init(&Debounce, NULL, TEST_LEN, Depth, Buffer) ==
+               IC74165_OK);
+    DebounceRef_Init(&Ref, TEST_LEN, Depth);
+
+    for (int Scan = 0; Scan < TEST_SCANS; Scan++)
+    {
+      uint8_t Changed;
+
+      // Inputs move now and then and bounce around their level
+      for (int i = 0; i < TEST_LEN; i++)
+      {
+        if (rand() % 16 == 0)
+          Level[i] ^= (uint8_t)(1U << (rand() % 8));
+        Sample[i] = Level[i];
+        if (rand() % 4 == 0)
+          Sample[i] ^= (uint8_t)rand();
+      }
+
+      IC74165_Debounce_Update(&Debounce, Sample, &Changed);
+      TEST_CHECK(Changed == DebounceRef_Update(&Ref, Sample));
+      if (memcmp(IC74165_Debounce_Data(&Debounce), Ref.State, TEST_LEN) != 0)
+      {
+        TEST_CHECK(!"debounced data differs from the reference");
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * @brief  A bounce shorter than Depth is filtered, a steady level is taken
+ *         after Depth scans of the chain.
+ */
+static void
+Test_Scan(void)
+{
+  IC74165_Debounce_t Debounce;
+  IC74165_Handler_t Handler = {0};
+  uint8_t Buffer[IC74165_DEBOUNCE_BUFFER_SIZE(TEST_LEN)];
+  uint8_t Changed;
+
+  IC74165_Sim_Reset(TEST_LEN);
+  IC74165_Platform_Init_Fast(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+  TEST_CHECK(IC74165_Debounce_Init(&Debounce, &Handler, TEST_LEN, 3, Buffer) ==
+             IC74165_OK);
+
+  IC74165_Sim_SetInputs(2, 0x0F);
+  TEST_CHECK(IC74165_Debounce_Scan(&Debounce, &Changed) == IC74165_OK);
+  TEST_CHECK(Changed == 0 && IC74165_Debounce_Data(&Debounce)[2] == 0x0F);
+
+  // Two scans of a bounce, then back to the old level
+  IC74165_Sim_SetInputs(2, 0xF0);
+  for (int i = 0; i < 2; i++)
+  {
+    TEST_CHECK(IC74165_Debounce_Scan(&Debounce, &Changed) == IC74165_OK);
+    TEST_CHECK(Changed == 0);
+  }
+  IC74165_Sim_SetInputs(2, 0x0F);
+  TEST_CHECK(IC74165_Debounce_Scan(&Debounce, &Changed) == IC74165_OK);
+  TEST_CHECK(Changed == 0 && IC74165_Debounce_Data(&Debounce)[2] == 0x0F);
+
+  // Three scans of a new level
+  IC74165_Sim_SetInputs(2, 0xF0);
+  IC74165_Sim_SetInputs(4, 0x81);
+  for (int i = 0; i < 3; i++)
+    TEST_CHECK(IC74165_Debounce_Scan(&Debounce, &Changed) == IC74165_OK);
+  TEST_CHECK(Changed == 1);
+  TEST_CHECK(IC74165_Debounce_Data(&Debounce)[2] == 0xF0);
+  TEST_CHECK(IC74165_Debounce_Data(&Debounce)[4] == 0x81);
+  TEST_CHECK(IC74165_Debounce_Data(&Debounce)[0] == 0x00);
+
+  IC74165_DeInit(&Handler);
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  Test_Init();
+  Test_Reference();
+  Test_Scan();
+
+  return TEST_RESULT();
+}
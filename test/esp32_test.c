@@ -0,0 +1,254 @@
+/**
+ **********************************************************************************
+ * @file   esp32_test.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Host tests of the ESP32 port on stubbed ESP-IDF drivers
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <string.h>
+#include "74165.h"
+#include "74165_platform.h"
+#include "esp32_stub.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define TEST_LEN     40
+#define TEST_FRAMES  10
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+static uint8_t Inputs[TEST_LEN];
+
+static struct
+{
+  uint32_t Frames;
+  uint32_t Wrong;
+  uint32_t NotOverlapped;
+} Continuous;
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+SetInputs(uint8_t Seed)
+{
+  for (uint16_t i = 0; i < TEST_LEN; i++)
+  {
+    Inputs[i] = (uint8_t)(Seed + i * 29);
+    Esp32Stub_SetInputs(i, Inputs[i]);
+  }
+}
+
+static void
+FrameCallback(const uint8_t *Data, uint16_t Len, void *Ctx)
+{
+  Esp32Stub_Stats_t Stats;
+
+  (void)Ctx;
+  Esp32Stub_GetStats(&Stats);
+
+  Continuous.Frames++;
+  if (Len != TEST_LEN || memcmp(Data, Inputs, TEST_LEN) != 0)
+    Continuous.Wrong++;
+  // The other frames are still queued while the application runs
+  if (Stats.InFlight < 2 * (IC74165_SPI_QUEUE_LEN - 1))
+    Continuous.NotOverlapped++;
+}
+
+static void
+Test_SPI(void)
+{
+  IC74165_Handler_t Handler = {0};
+  Esp32Stub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  Esp32Stub_Reset();
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(1);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  SetInputs(9);
+  TEST_CHECK(IC74165_TryReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  SetInputs(2);
+  memset(Data, 0, sizeof(Data));
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 7, 20) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[7], 20) == 0);
+
+  SetInputs(3);
+  TEST_CHECK(IC74165_ReadAllAsync(&Handler, Data, NULL, NULL) == IC74165_OK);
+  while (IC74165_Poll(&Handler) == IC74165_BUSY)
+  {
+  }
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  Esp32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.ClkInh == 1);
+  TEST_CHECK(Stats.BusHeld == 0);
+  TEST_CHECK(Stats.InFlight == 0);
+
+  IC74165_DeInit(&Handler);
+  Esp32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.Allocs == 0);
+  TEST_CHECK(Stats.Blocked == 0 && Stats.Misuse == 0);
+}
+
+/**
+ * @brief  The fast mode drives the pins through the W1TS/W1TC registers and
+ *         holds each CLK phase for the cycles of the handler's profile.
+ */
+static void
+Test_Fast(void)
+{
+  const IC74165_Timing_t Slow = {0, 1000, 2000, 0};
+  IC74165_Handler_t Handler = {0};
+  Esp32Stub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  Esp32Stub_Reset();
+  IC74165_Platform_Init_Fast(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(5);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  SetInputs(6);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 3, 30) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[3], 30) == 0);
+  IC74165_DeInit(&Handler);
+
+  // 240 cycles per us, net of the register latency
+  Esp32Stub_Reset();
+  Handler.Timing = Slow;
+  IC74165_Platform_Init_Fast(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(7);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  Esp32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.MinClkHighCycles >=
+             ((1000 - IC74165_FAST_EDGE_LATENCY) * 240 + 999) / 1000);
+  TEST_CHECK(Stats.MinClkLowCycles >=
+             ((2000 - IC74165_FAST_EDGE_LATENCY) * 240 + 999) / 1000);
+  TEST_CHECK(Stats.ClkInh == 1);
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  Frames are handed over while the next ones are queued, and each
+ *         frame holds the inputs of its own scan.
+ */
+static void
+Test_Continuous(void)
+{
+  IC74165_Handler_t Handler = {0};
+  Esp32Stub_Stats_t Stats;
+
+  Esp32Stub_Reset();
+  memset(&Continuous, 0, sizeof(Continuous));
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  TEST_CHECK(IC74165_Platform_SPI_ContinuousProcess(0) == IC74165_FAIL);
+  TEST_CHECK(IC74165_Platform_SPI_ContinuousStart(&Handler, FrameCallback, NULL) ==
+             IC74165_OK);
+  TEST_CHECK(IC74165_Platform_SPI_ContinuousStart(&Handler, FrameCallback, NULL) ==
+             IC74165_FAIL);
+
+  Esp32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.InFlight == 2 * IC74165_SPI_QUEUE_LEN);
+  TEST_CHECK(Stats.ClkInh == 0);
+  TEST_CHECK(Stats.BusHeld == IC74165_SPI_ACQUIRE_BUS);
+#if (IC74165_SPI_ACQUIRE_BUS)
+  // The run holds the port, so a try-scan fails without waiting
+  {
+    uint8_t Data[TEST_LEN];
+    TEST_CHECK(IC74165_TryReadAll(&Handler, Data) == IC74165_BUSY);
+    Esp32Stub_GetStats(&Stats);
+    TEST_CHECK(Stats.Blocked == 0);
+  }
+#endif
+
+  for (uint8_t k = 0; k < TEST_FRAMES; k++)
+  {
+    SetInputs(k * 7);
+    TEST_CHECK(IC74165_Platform_SPI_ContinuousProcess(10) == IC74165_OK);
+  }
+  TEST_CHECK(Continuous.Frames == TEST_FRAMES);
+  TEST_CHECK(Continuous.Wrong == 0);
+  TEST_CHECK(Continuous.NotOverlapped == 0);
+
+  IC74165_Platform_SPI_ContinuousStop();
+  Esp32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.InFlight == 0);
+  TEST_CHECK(Stats.ClkInh == 1);
+  TEST_CHECK(Stats.BusHeld == 0);
+  TEST_CHECK(IC74165_Platform_SPI_ContinuousProcess(0) == IC74165_FAIL);
+
+  // The handler is usable again after stop
+  SetInputs(99);
+  {
+    uint8_t Data[TEST_LEN];
+    TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+    TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  }
+
+  IC74165_DeInit(&Handler);
+  Esp32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.Allocs == 0);
+  TEST_CHECK(Stats.Blocked == 0 && Stats.Misuse == 0);
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  Test_Fast();
+  Test_SPI();
+  Test_Continuous();
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,148 @@
+/**
+ **********************************************************************************
+ * @file   gpio_sim_test.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Test of the Linux port on a gpio-sim chip (see run.sh)
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "74165.h"
+#include "74165_platform.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define TEST_LEN    4
+#define TEST_SCANS  1000
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+// sysfs directory of the simulated chip
+static const char *Sim;
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static int
+SimWrite(unsigned int Line, const char *Attr, const char *Value)
+{
+  char Path[256];
+  FILE *File;
+
+  snprintf(Path, sizeof(Path), "%s/sim_gpio%u/%s", Sim, Line, Attr);
+  File = fopen(Path, "w");
+  if (File == NULL)
+    return -1;
+  fputs(Value, File);
+  return fclose(File);
+}
+
+static int
+SimRead(unsigned int Line)
+{
+  char Path[256];
+  FILE *File;
+  int Value = -1;
+
+  snprintf(Path, sizeof(Path), "%s/sim_gpio%u/value", Sim, Line);
+  File = fopen(Path, "r");
+  if (File == NULL)
+    return -1;
+  if (fscanf(File, "%d", &Value) != 1)
+    Value = -1;
+  fclose(File);
+  return Value;
+}
+
+static void
+Test_Level(IC74165_Handler_t *Handler, const char *Pull, uint8_t Expected)
+{
+  uint8_t Data[TEST_LEN];
+  uint8_t Ref[TEST_LEN];
+
+  TEST_CHECK(SimWrite(IC74165_QH_LINE, "pull", Pull) == 0);
+  memset(Ref, Expected, sizeof(Ref));
+  memset(Data, (uint8_t)~Expected, sizeof(Data));
+  TEST_CHECK(IC74165_ReadAll(Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Ref, TEST_LEN) == 0);
+
+  // Idle levels after the scan
+  TEST_CHECK(SimRead(IC74165_CLK_LINE) == 0);
+  TEST_CHECK(SimRead(IC74165_SHLD_LINE) == 1);
+#if (IC74165_CLKINH_ENABLE)
+  TEST_CHECK(SimRead(IC74165_CLKINH_LINE) == 1);
+#endif
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(int argc, char *argv[])
+{
+  IC74165_Handler_t Handler = {0};
+  uint8_t Data[TEST_LEN];
+  struct timespec Start, End;
+  double Ns;
+
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <sysfs directory of the gpio-sim chip>\n", argv[0]);
+    return 2;
+  }
+  Sim = argv[1];
+
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  Test_Level(&Handler, "pull-up", 0xFF);
+  Test_Level(&Handler, "pull-down", 0x00);
+
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  for (int i = 0; i < TEST_SCANS; i++)
+    IC74165_ReadAll(&Handler, Data);
+  clock_gettime(CLOCK_MONOTONIC, &End);
+  Ns = (End.tv_sec - Start.tv_sec) * 1e9 + (End.tv_nsec - Start.tv_nsec);
+  printf("%d-byte scan: %.1f us\n", TEST_LEN, Ns / TEST_SCANS / 1000);
+
+  IC74165_DeInit(&Handler);
+  return TEST_RESULT();
+}
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Run the GPIO path of port/Linux against a gpio-sim chip.
+#
+# Needs root, the gpio-sim module (CONFIG_GPIO_SIM), configfs and libgpiod v2.
+# gpio-sim has no 74165 behind its lines, so Qh is driven through the pull of
+# its line: the test checks the reads, the idle levels of CLK and SH/LD and
+# the time of a scan through the real uAPI.
+set -e
+
+cd "$(dirname "$0")"
+BUILD=${BUILD:-../build/gpio-sim}
+CC=${CC:-cc}
+CFG=/sys/kernel/config/gpio-sim/ic74165
+
+cleanup()
+{
+  [ -e $CFG/live ] && echo 0 > $CFG/live
+  [ -d $CFG/gpio-bank0 ] && rmdir $CFG/gpio-bank0
+  [ -d $CFG ] && rmdir $CFG
+}
+
+modprobe gpio-sim
+mountpoint -q /sys/kernel/config || mount -t configfs none /sys/kernel/config
+trap cleanup EXIT
+mkdir $CFG $CFG/gpio-bank0
+echo 32 > $CFG/gpio-bank0/num_lines
+echo 1 > $CFG/live
+
+CHIP=$(cat $CFG/gpio-bank0/chip_name)
+SIM=/sys/devices/platform/$(cat $CFG/dev_name)/$CHIP
+
+# Point the port at the simulated chip, like a user edits the options
+mkdir -p $BUILD
+sed -e "s|^\(#define IC74165_GPIO_CHIP  *\).*|\1\"/dev/$CHIP\"|" \
+  ../../port/Linux/74165_platform.h > $BUILD/74165_platform.h
+cp ../../port/Linux/74165_platform.c $BUILD/
+$CC -std=c99 -O2 -Wall -Wextra -I../../src/include -I.. -I$BUILD gpio_sim_test.c \
+  $BUILD/74165_platform.c ../../src/74165.c -lgpiod -o $BUILD/gpio_sim_test
+
+$BUILD/gpio_sim_test "$SIM"
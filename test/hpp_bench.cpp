@@ -0,0 +1,171 @@
+/**
+ **********************************************************************************
+ * @file   hpp_bench.cpp
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Benchmark of the C++ front-end against the C driver
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "74165.h"
+#include "74165.hpp"
+#include "chain_stub.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define BENCH_ROUNDS  20000
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+/**
+ * @brief  Port policy of the C++ front-end, on the same pin stubs that the C
+ *         driver calls through its function pointers.
+ */
+struct StubPort
+{
+  static void ClkWrite(uint8_t Level) { ChainStub_ClkWrite(Level); }
+  static void ShLdWrite(uint8_t Level) { ChainStub_ShLdWrite(Level); }
+  static uint8_t QhRead(void) { return ChainStub_QhRead(); }
+  static void DelayNs(uint16_t Delay) { ChainStub_DelayNs(Delay); }
+};
+
+static void
+StubClkWrite(uint8_t Level)
+{
+  ChainStub_ClkWrite(Level);
+}
+
+static void
+StubShLdWrite(uint8_t Level)
+{
+  ChainStub_ShLdWrite(Level);
+}
+
+static uint8_t
+StubQhRead(void)
+{
+  return ChainStub_QhRead();
+}
+
+static void
+StubDelayNs(uint16_t Delay)
+{
+  ChainStub_DelayNs(Delay);
+}
+
+static double
+NowNs(void)
+{
+  struct timespec Ts;
+  clock_gettime(CLOCK_MONOTONIC, &Ts);
+  return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+/**
+ * @brief  Read a ChainLen chain with both front-ends and print the time of one
+ *         scan.
+ * @retval 0 if both read the stub inputs, 1 otherwise
+ */
+template <size_t ChainLen>
+static int
+Bench(void)
+{
+  using Chain = IC74165<StubPort, ChainLen>;
+  IC74165_Handler_t Handler = {};
+  uint8_t Data[ChainLen];
+  typename Chain::Data_t DataCpp;
+  uint32_t Sum = 0;
+  double Start, TimeC, TimeCpp;
+
+  for (size_t i = 0; i < ChainLen; i++)
+    ChainStub.Inputs[i] = (uint8_t)(i * 37 + 11);
+
+  IC74165_PLATFORM_SET_COMMUNICATION(&Handler, IC74165_COMMUNICATION_GPIO);
+  IC74165_PLATFORM_LINK_GPIO_CLKWRITE(&Handler, StubClkWrite);
+  IC74165_PLATFORM_LINK_GPIO_SHLDWRITE(&Handler, StubShLdWrite);
+  IC74165_PLATFORM_LINK_GPIO_QHREAD(&Handler, StubQhRead);
+  IC74165_PLATFORM_LINK_GPIO_DELAYNS(&Handler, StubDelayNs);
+  if (IC74165_InitWide(&Handler, ChainLen) != IC74165_OK)
+    return 1;
+  Chain::Init();
+
+  Start = NowNs();
+  for (int r = 0; r < BENCH_ROUNDS; r++)
+  {
+    IC74165_ReadAll(&Handler, Data);
+    Sum += Data[r % ChainLen];
+  }
+  TimeC = (NowNs() - Start) / BENCH_ROUNDS;
+
+  Start = NowNs();
+  for (int r = 0; r < BENCH_ROUNDS; r++)
+  {
+    DataCpp = Chain::ReadAll();
+    Sum += DataCpp[r % ChainLen];
+  }
+  TimeCpp = (NowNs() - Start) / BENCH_ROUNDS;
+
+  printf("%4u bytes: C %10.1f ns  C++ %10.1f ns  speedup %5.2fx  (sum %08x)\n",
+         (unsigned)ChainLen, TimeC, TimeCpp, TimeC / TimeCpp, (unsigned)Sum);
+
+  IC74165_DeInit(&Handler);
+  if (memcmp(Data, ChainStub.Inputs, ChainLen) != 0 ||
+      memcmp(DataCpp.data(), ChainStub.Inputs, ChainLen) != 0)
+  {
+    printf("%4u bytes: data mismatch\n", (unsigned)ChainLen);
+    return 1;
+  }
+  return 0;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  int Fail = 0;
+
+  Fail |= Bench<1>();
+  Fail |= Bench<8>();
+  Fail |= Bench<64>();
+  Fail |= Bench<512>();
+
+  return Fail;
+}
@@ -0,0 +1,167 @@
+/**
+ **********************************************************************************
+ * @file   linux_test.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Host tests of the Linux port on stubbed libgpiod and spidev
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <string.h>
+#include "74165.h"
+#include "74165_platform.h"
+#include "linux_stub.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define TEST_LEN  12
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+static uint8_t Inputs[TEST_LEN];
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+SetInputs(uint8_t Seed)
+{
+  for (uint16_t i = 0; i < TEST_LEN; i++)
+  {
+    Inputs[i] = (uint8_t)(Seed + i * 53);
+    LinuxStub_SetInputs(i, Inputs[i]);
+  }
+}
+
+/**
+ * @brief  ShiftBytes reads the chain with three ioctls per bit; the load and
+ *         CLK-INH add a few per scan.
+ */
+static void
+Test_GPIO(void)
+{
+  IC74165_Handler_t Handler = {0};
+  LinuxStub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  LinuxStub_Reset(1);
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(1);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  LinuxStub_GetStats(&Stats);
+  TEST_CHECK(Stats.Ioctls >= 3 * 8 * TEST_LEN);
+  TEST_CHECK(Stats.Ioctls <= 3 * 8 * TEST_LEN + 4);
+
+  SetInputs(2);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 5, 4) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[5], 4) == 0);
+
+  LinuxStub_GetStats(&Stats);
+  TEST_CHECK(Stats.ClkInh == IC74165_CLKINH_ENABLE);
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  The load goes out with the shift in one message, and MOSI stays high
+ *         between the skip and data messages of a wide read.
+ */
+static void
+Test_SPI(void)
+{
+  IC74165_Handler_t Handler = {0};
+  LinuxStub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  LinuxStub_Reset(1);
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(3);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  LinuxStub_GetStats(&Stats);
+  TEST_CHECK(Stats.Messages == 1);
+  TEST_CHECK(Stats.Transfers == 2);
+
+  SetInputs(4);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 2, 7) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[2], 7) == 0);
+
+  LinuxStub_GetStats(&Stats);
+  TEST_CHECK(Stats.IdleLoads == 0);
+  TEST_CHECK(Stats.ClkInh == IC74165_CLKINH_ENABLE);
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  A controller that cannot keep MOSI high leaves the port closed, so
+ *         reads fail instead of returning reloaded data.
+ */
+static void
+Test_SPINoIdleHigh(void)
+{
+  IC74165_Handler_t Handler = {0};
+  LinuxStub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  LinuxStub_Reset(0);
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(5);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_FAIL);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 2, 7) == IC74165_FAIL);
+  LinuxStub_GetStats(&Stats);
+  TEST_CHECK(Stats.Messages == 0);
+  IC74165_DeInit(&Handler);
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  Test_GPIO();
+  Test_SPI();
+  Test_SPINoIdleHigh();
+
+  return TEST_RESULT();
+}
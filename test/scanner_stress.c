@@ -0,0 +1,159 @@
+/**
+ **********************************************************************************
+ * @file   scanner_stress.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Multi-threaded stress test of the scanner snapshot
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdio.h>
+#include "74165.h"
+#include "74165_scanner.h"
+#include "74165_platform.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define STRESS_LEN      64
+#define STRESS_SCANS    5000
+#define STRESS_READERS  4
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+static IC74165_Scanner_t Scanner;
+static volatile int Done = 0;
+
+static struct
+{
+  unsigned long Reads;
+  unsigned long Torn;
+  unsigned long Backward;
+} ReaderStats[STRESS_READERS];
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+/**
+ * @brief  Scan k drives every input byte to k, with timestamp k.
+ */
+static void *
+Writer(void *Arg)
+{
+  (void)Arg;
+
+  for (uint32_t k = 1; k <= STRESS_SCANS; k++)
+  {
+    for (uint16_t i = 0; i < STRESS_LEN; i++)
+      IC74165_Sim_SetInputs(i, (uint8_t)k);
+    TEST_CHECK(IC74165_Scanner_Scan(&Scanner, k) == IC74165_OK);
+  }
+
+  Done = 1;
+  return NULL;
+}
+
+/**
+ * @brief  Every copy must be one whole scan, matching its timestamp, and
+ *         generations must not go back.
+ */
+static void *
+Reader(void *Arg)
+{
+  int Id = (int)(size_t)Arg;
+  uint8_t Data[STRESS_LEN];
+  uint32_t Generation, Timestamp, LastGeneration = 0;
+
+  while (!Done)
+  {
+    if (IC74165_Scanner_Get(&Scanner, Data, &Generation, &Timestamp) != IC74165_OK)
+      continue;
+
+    ReaderStats[Id].Reads++;
+    if (Generation < LastGeneration)
+      ReaderStats[Id].Backward++;
+    LastGeneration = Generation;
+
+    for (uint16_t i = 0; i < STRESS_LEN; i++)
+    {
+      if (Data[i] != (uint8_t)Timestamp)
+      {
+        ReaderStats[Id].Torn++;
+        break;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  static uint8_t Buffer[IC74165_SCANNER_BUFFER_SIZE(STRESS_LEN)];
+  IC74165_Handler_t Handler = {0};
+  pthread_t WriterThread, ReaderThread[STRESS_READERS];
+  unsigned long Reads = 0;
+
+  IC74165_Sim_Reset(STRESS_LEN);
+  IC74165_Platform_Init_Fast(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, STRESS_LEN) == IC74165_OK);
+  TEST_CHECK(IC74165_Scanner_Init(&Scanner, &Handler, 1, Buffer) == IC74165_OK);
+
+  for (int i = 0; i < STRESS_READERS; i++)
+    pthread_create(&ReaderThread[i], NULL, Reader, (void *)(size_t)i);
+  pthread_create(&WriterThread, NULL, Writer, NULL);
+
+  pthread_join(WriterThread, NULL);
+  for (int i = 0; i < STRESS_READERS; i++)
+  {
+    pthread_join(ReaderThread[i], NULL);
+    Reads += ReaderStats[i].Reads;
+    TEST_CHECK(ReaderStats[i].Torn == 0);
+    TEST_CHECK(ReaderStats[i].Backward == 0);
+  }
+
+  printf("%d scans, %lu reads by %d readers\n", STRESS_SCANS, Reads,
+         STRESS_READERS);
+  TEST_CHECK(Reads > 0);
+
+  IC74165_DeInit(&Handler);
+  return TEST_RESULT();
+}
@@ -0,0 +1,238 @@
+/**
+ **********************************************************************************
+ * @file   stm32_test.c
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Host tests of the STM32 port on a stubbed HAL
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Includes ---------------------------------------------------------------------*/
+#include <string.h>
+#include "main.h"
+#include "74165.h"
+#include "74165_platform.h"
+#include "stm32_stub.h"
+#include "test.h"
+
+
+/* Private Constants ------------------------------------------------------------*/
+#define TEST_LEN  12
+
+
+
+/* Private Variables ------------------------------------------------------------*/
+SPI_HandleTypeDef hspi1;
+static uint8_t Inputs[TEST_LEN];
+
+
+
+/**
+ ==================================================================================
+                           ##### Private Functions #####                           
+ ==================================================================================
+ */
+
+static void
+SetInputs(uint8_t Seed)
+{
+  for (uint16_t i = 0; i < TEST_LEN; i++)
+  {
+    Inputs[i] = (uint8_t)(Seed + i * 53);
+    Stm32Stub_SetInputs(i, Inputs[i]);
+  }
+}
+
+#if (IC74165_SPI_ENABLE) && !(IC74165_SPI_HAL_CALLBACK)
+// The application forwards the HAL callbacks
+void
+HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  IC74165_Platform_SPI_TxRxCpltCallback(hspi);
+}
+
+void
+HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  IC74165_Platform_SPI_ErrorCallback(hspi);
+}
+#endif
+
+static void
+Test_GPIO(void)
+{
+  IC74165_Handler_t Handler = {0};
+  uint8_t Data[TEST_LEN];
+
+  Stm32Stub_Reset(0);
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(1);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  SetInputs(2);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 5, 4) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[5], 4) == 0);
+
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  Each CLK phase lasts at least the profile, net of the measured edge
+ *         cost, on the DWT counter and on the calibrated software loop.
+ */
+static void
+Test_Timing(void)
+{
+  const IC74165_Timing_t Slow = {0, 1000, 2000, 0};
+  IC74165_Handler_t Handler = {0};
+  Stm32Stub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+  uint32_t CyclesPerUs = SystemCoreClock / 1000000;
+  uint16_t EdgeCost;
+
+  Stm32Stub_Reset(0);
+  Handler.Timing = Slow;
+  IC74165_Platform_Init(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  // Two cycles per modelled BSRR store
+  EdgeCost = IC74165_Platform_GetEdgeCostNs();
+#if (IC74165_DELAY_DWT)
+  TEST_CHECK(EdgeCost == 2 * 1000 / CyclesPerUs);
+#else
+  TEST_CHECK(EdgeCost == 0);
+#endif
+
+  SetInputs(7);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  Stm32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.MinClkHighCycles >=
+             ((1000 - EdgeCost) * CyclesPerUs + 999) / 1000);
+  TEST_CHECK(Stats.MinClkLowCycles >=
+             ((2000 - EdgeCost) * CyclesPerUs + 999) / 1000);
+  IC74165_DeInit(&Handler);
+}
+
+#if (IC74165_SPI_ENABLE)
+static void
+Test_SPI(void)
+{
+  IC74165_Handler_t Handler = {0};
+  Stm32Stub_Stats_t Stats;
+  uint8_t Data[TEST_LEN];
+
+  Stm32Stub_Reset(0);
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(3);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+  SetInputs(4);
+  TEST_CHECK(IC74165_ReadWide(&Handler, Data, 2, 7) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, &Inputs[2], 7) == 0);
+
+  // A DMA error fails the scan instead of returning stale data
+  Stm32Stub_FailNext();
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_FAIL);
+  SetInputs(5);
+  TEST_CHECK(IC74165_ReadAll(&Handler, Data) == IC74165_OK);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  Stm32Stub_GetStats(&Stats);
+  TEST_CHECK(Stats.ClkInh == 1);
+  TEST_CHECK(Stats.Running == 0);
+  IC74165_DeInit(&Handler);
+}
+
+/**
+ * @brief  The scan runs on the DMA while the caller polls.
+ */
+static void
+Test_Async(void)
+{
+  IC74165_Handler_t Handler = {0};
+  uint8_t Data[TEST_LEN];
+  uint32_t Polls = 0;
+
+  Stm32Stub_Reset(1);
+  IC74165_Platform_Init_SPI(&Handler);
+  TEST_CHECK(IC74165_InitWide(&Handler, TEST_LEN) == IC74165_OK);
+
+  SetInputs(6);
+  TEST_CHECK(IC74165_ReadAllAsync(&Handler, Data, NULL, NULL) == IC74165_OK);
+  while (IC74165_Poll(&Handler) == IC74165_BUSY && Polls < 100)
+  {
+    Polls++;
+    Stm32Stub_Irq();
+  }
+  TEST_CHECK(Polls > 0 && Polls < 100);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  // A DMA error fails the read in IC74165_Poll and frees the handler
+  Stm32Stub_FailNext();
+  TEST_CHECK(IC74165_ReadAllAsync(&Handler, Data, NULL, NULL) == IC74165_OK);
+  Stm32Stub_Irq();
+  TEST_CHECK(IC74165_Poll(&Handler) == IC74165_FAIL);
+  TEST_CHECK(IC74165_IsBusy(&Handler) == 0);
+
+  SetInputs(7);
+  Polls = 0;
+  TEST_CHECK(IC74165_ReadAllAsync(&Handler, Data, NULL, NULL) == IC74165_OK);
+  while (IC74165_Poll(&Handler) == IC74165_BUSY && Polls < 100)
+  {
+    Polls++;
+    Stm32Stub_Irq();
+  }
+  TEST_CHECK(Polls > 0 && Polls < 100);
+  TEST_CHECK(memcmp(Data, Inputs, TEST_LEN) == 0);
+
+  IC74165_DeInit(&Handler);
+}
+#endif
+
+
+
+/**
+ ==================================================================================
+                            ##### Public Functions #####                           
+ ==================================================================================
+ */
+
+int
+main(void)
+{
+  Test_GPIO();
+  Test_Timing();
+#if (IC74165_SPI_ENABLE)
+  Test_SPI();
+  Test_Async();
+#endif
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,12 @@
+/* Host stub of avr/interrupt.h. The SPI interrupt is raised by
+ * AvrStub_Irq. */
+#ifndef _STUB_AVR_INTERRUPT_H_
+#define _STUB_AVR_INTERRUPT_H_
+
+#define ISR(vector)  void vector(void)
+#define sei()
+#define cli()
+
+void AvrStub_SpiStcIsr(void);
+
+#endif
@@ -0,0 +1,56 @@
+/* Host stub of the avr/io.h parts used by port/ATmega32-GCC. Each register
+ * access goes through test/stub/avr/avr_stub.c, so the chain model sees the
+ * writes. */
+#ifndef _STUB_AVR_IO_H_
+#define _STUB_AVR_IO_H_
+
+#include <stdint.h>
+
+enum
+{
+  AVR_STUB_DDRA,
+  AVR_STUB_PORTA,
+  AVR_STUB_PINA,
+  AVR_STUB_DDRB,
+  AVR_STUB_PORTB,
+  AVR_STUB_SPCR,
+  AVR_STUB_SPSR,
+  AVR_STUB_REGS
+};
+
+volatile uint8_t *AvrStub_Reg(uint8_t Reg);
+// SPDR is 9 bits wide here: bit 8 is set on each access, so a write is seen
+// even if it stores the received value again
+volatile uint16_t *AvrStub_Spdr(void);
+
+#define DDRA   (*AvrStub_Reg(AVR_STUB_DDRA))
+#define PORTA  (*AvrStub_Reg(AVR_STUB_PORTA))
+#define PINA   (*AvrStub_Reg(AVR_STUB_PINA))
+#define DDRB   (*AvrStub_Reg(AVR_STUB_DDRB))
+#define PORTB  (*AvrStub_Reg(AVR_STUB_PORTB))
+#define SPCR   (*AvrStub_Reg(AVR_STUB_SPCR))
+#define SPSR   (*AvrStub_Reg(AVR_STUB_SPSR))
+#define SPDR   (*AvrStub_Spdr())
+
+#define PB4    4
+#define PB5    5
+#define PB6    6
+#define PB7    7
+
+// SPCR
+#define SPR0   0
+#define SPR1   1
+#define CPHA   2
+#define CPOL   3
+#define MSTR   4
+#define DORD   5
+#define SPE    6
+#define SPIE   7
+// SPSR
+#define SPI2X  0
+#define WCOL   6
+#define SPIF   7
+
+#define SPI_STC_vect  AvrStub_SpiStcIsr
+
+#endif
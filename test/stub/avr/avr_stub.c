@@ -0,0 +1,183 @@
+/* Host stubs of the avr-libc parts used by port/ATmega32-GCC, driving the
+ * inline chain model of test/chain_stub.h */
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "74165_platform.h"
+#include "chain_stub.h"
+#include "avr_stub.h"
+
+// Modelled cost of an I/O register access (cycles), as sbi/cbi
+#define STUB_IO_CYCLES 2
+
+#define STUB_SPDR_ARMED 0x100
+
+static struct
+{
+  AvrStub_Stats_t Stats;
+  uint8_t Regs[AVR_STUB_REGS];
+  volatile uint16_t Spdr;
+  uint8_t Received;
+  uint8_t PortA;
+  uint32_t ClkRise;
+  uint32_t ClkFall;
+  uint8_t ClkFallSeen;
+} Stub;
+
+
+/* Pins and time ---------------------------------------------------------------*/
+
+static void
+Stub_ClkWrite(uint8_t Level)
+{
+  uint32_t Now = Stub.Stats.Cycles;
+
+  if (Level && !ChainStub.Clk)
+  {
+    if (Stub.ClkFallSeen && Now - Stub.ClkFall < Stub.Stats.MinClkLowCycles)
+      Stub.Stats.MinClkLowCycles = Now - Stub.ClkFall;
+    Stub.ClkRise = Now;
+  }
+  else if (!Level && ChainStub.Clk)
+  {
+    if (Now - Stub.ClkRise < Stub.Stats.MinClkHighCycles)
+      Stub.Stats.MinClkHighCycles = Now - Stub.ClkRise;
+    Stub.ClkFall = Now;
+    Stub.ClkFallSeen = 1;
+  }
+  ChainStub_ClkWrite(Level);
+}
+
+/**
+ * @brief  SPI mode 1 with MOSI on SH/LD and SCK on CLK, like port/Host-Sim.
+ */
+static void
+Stub_Transfer(uint8_t Send)
+{
+  uint8_t Buffer = 0;
+
+  for (int8_t j = 7; j >= 0; j--)
+  {
+    ChainStub_ClkWrite(1);
+    ChainStub_ShLdWrite((Send >> j) & 1);
+    Buffer |= ChainStub_QhRead() << j;
+    ChainStub_ClkWrite(0);
+  }
+  Stub.Received = Buffer;
+  Stub.Regs[AVR_STUB_SPSR] |= (1<<SPIF);
+  Stub.Stats.Transfers++;
+}
+
+/**
+ * @brief  Apply the last register writes: PORTA to the pins and SPDR to the
+ *         SPI. It runs on every register access and delay, so a write takes
+ *         effect before the time goes on.
+ */
+static void
+Stub_Flush(void)
+{
+  uint8_t Old = Stub.PortA;
+  uint8_t New = Stub.Regs[AVR_STUB_PORTA];
+
+  Stub.PortA = New;
+  if ((Old ^ New) & (1<<IC74165_CLK_NUM))
+    Stub_ClkWrite((New >> IC74165_CLK_NUM) & 1);
+  if ((Old ^ New) & (1<<IC74165_SHLD_NUM))
+    ChainStub_ShLdWrite((New >> IC74165_SHLD_NUM) & 1);
+  if ((Old ^ New) & (1<<IC74165_CLKINH_NUM))
+  {
+    ChainStub_ClkInhWrite((New >> IC74165_CLKINH_NUM) & 1);
+    Stub.Stats.ClkInh = (New >> IC74165_CLKINH_NUM) & 1;
+  }
+
+  if (!(Stub.Spdr & STUB_SPDR_ARMED))
+  {
+    Stub.Spdr |= STUB_SPDR_ARMED;
+    if (Stub.Regs[AVR_STUB_SPCR] & (1<<SPE))
+      Stub_Transfer((uint8_t)Stub.Spdr);
+  }
+}
+
+volatile uint8_t *
+AvrStub_Reg(uint8_t Reg)
+{
+  Stub_Flush();
+  Stub.Stats.Cycles += STUB_IO_CYCLES;
+  if (Reg == AVR_STUB_PINA)
+    Stub.Regs[Reg] = ChainStub_QhRead() ? (1<<IC74165_QH_NUM) : 0;
+  return &Stub.Regs[Reg];
+}
+
+volatile uint16_t *
+AvrStub_Spdr(void)
+{
+  Stub_Flush();
+  Stub.Stats.Cycles += STUB_IO_CYCLES;
+  // Accessing SPDR after SPIF was set clears it
+  Stub.Regs[AVR_STUB_SPSR] &= ~(1<<SPIF);
+  Stub.Spdr = STUB_SPDR_ARMED | Stub.Received;
+  return &Stub.Spdr;
+}
+
+void
+AvrStub_Delay(uint32_t Cycles)
+{
+  Stub_Flush();
+  Stub.Stats.Cycles += Cycles;
+}
+
+// Weak default for builds without IC74165_SPI_USE_ISR
+__attribute__((weak)) void
+AvrStub_SpiStcIsr(void)
+{
+}
+
+
+/* Test interface --------------------------------------------------------------*/
+
+void
+AvrStub_Reset(void)
+{
+  memset(&Stub, 0, sizeof(Stub));
+  memset(&ChainStub, 0, sizeof(ChainStub));
+
+  // CLK-INH starts high, so a scan that does not take it low reads no data.
+  // Without IC74165_CLKINH_ENABLE it is tied low.
+  ChainStub.ShLd = 1;
+  ChainStub.ClkInh = IC74165_CLKINH_ENABLE;
+  Stub.Stats.ClkInh = IC74165_CLKINH_ENABLE;
+  Stub.PortA = IC74165_CLKINH_ENABLE ? (1<<IC74165_CLKINH_NUM) : 0;
+  Stub.Regs[AVR_STUB_PORTA] = Stub.PortA;
+  Stub.Spdr = STUB_SPDR_ARMED;
+  Stub.Stats.MinClkHighCycles = UINT32_MAX;
+  Stub.Stats.MinClkLowCycles = UINT32_MAX;
+}
+
+void
+AvrStub_SetInputs(uint16_t Chip, uint8_t Value)
+{
+  if (Chip < CHAIN_STUB_MAX_CHIPS)
+    ChainStub.Inputs[Chip] = Value;
+}
+
+uint8_t
+AvrStub_Irq(void)
+{
+  Stub_Flush();
+  if (!(Stub.Regs[AVR_STUB_SPSR] & (1<<SPIF)) ||
+      !(Stub.Regs[AVR_STUB_SPCR] & (1<<SPIE)))
+    return 0;
+
+  // SPIF is cleared when the interrupt is taken
+  Stub.Regs[AVR_STUB_SPSR] &= ~(1<<SPIF);
+  Stub.Stats.Irqs++;
+  AvrStub_SpiStcIsr();
+  return 1;
+}
+
+void
+AvrStub_GetStats(AvrStub_Stats_t *Stats)
+{
+  Stub_Flush();
+  *Stats = Stub.Stats;
+}
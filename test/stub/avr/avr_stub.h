@@ -0,0 +1,43 @@
+/* Chain model behind the avr-libc host stubs, for test/avr_test.c */
+#ifndef _AVR_STUB_H_
+#define _AVR_STUB_H_
+
+#include <stdint.h>
+
+/**
+ * @brief  Counters of the stubs
+ */
+typedef struct AvrStub_Stats_s
+{
+  // Modelled CPU cycles
+  uint32_t Cycles;
+  // SPI bytes transferred and SPI interrupts taken
+  uint32_t Transfers;
+  uint32_t Irqs;
+  // Level of CLK-INH
+  uint8_t ClkInh;
+  // Shortest CLK high and low phases of the GPIO pins (cycles, UINT32_MAX if
+  // none)
+  uint32_t MinClkHighCycles;
+  uint32_t MinClkLowCycles;
+} AvrStub_Stats_t;
+
+/**
+ * @brief  Reset the stubs and the chain model. All inputs are 0.
+ */
+void AvrStub_Reset(void);
+
+/**
+ * @brief  Set parallel inputs of a chip. Chip 0 drives Qh.
+ */
+void AvrStub_SetInputs(uint16_t Chip, uint8_t Value);
+
+/**
+ * @brief  Take the SPI interrupt if SPIF and SPIE are set.
+ * @retval 1 if the interrupt was taken
+ */
+uint8_t AvrStub_Irq(void);
+
+void AvrStub_GetStats(AvrStub_Stats_t *Stats);
+
+#endif
@@ -0,0 +1,17 @@
+/* Host stub of util/delay.h */
+#ifndef _STUB_UTIL_DELAY_H_
+#define _STUB_UTIL_DELAY_H_
+
+#ifndef F_CPU
+#error "F_CPU must be defined before util/delay.h"
+#endif
+
+#include "util/delay_basic.h"
+
+static inline void
+_delay_us(double Us)
+{
+  AvrStub_Delay((uint32_t)(Us * (F_CPU / 1000000.0) + 0.5));
+}
+
+#endif
@@ -0,0 +1,16 @@
+/* Host stub of util/delay_basic.h: the loops only advance the cycle counter */
+#ifndef _STUB_UTIL_DELAY_BASIC_H_
+#define _STUB_UTIL_DELAY_BASIC_H_
+
+#include <stdint.h>
+
+void AvrStub_Delay(uint32_t Cycles);
+
+// 3 cycles per iteration, 0 runs 256 iterations
+static inline void
+_delay_loop_1(uint8_t Count)
+{
+  AvrStub_Delay(3UL * (Count ? Count : 256));
+}
+
+#endif
@@ -0,0 +1,26 @@
+/* Host stub of ESP-IDF driver/gpio.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_DRIVER_GPIO_H_
+#define _STUB_DRIVER_GPIO_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_17 17
+#define GPIO_NUM_18 18
+#define GPIO_NUM_22 22
+#define GPIO_NUM_23 23
+
+typedef enum
+{
+  GPIO_MODE_INPUT = 1,
+  GPIO_MODE_OUTPUT = 2
+} gpio_mode_t;
+
+esp_err_t gpio_reset_pin(gpio_num_t Pin);
+esp_err_t gpio_set_direction(gpio_num_t Pin, gpio_mode_t Mode);
+esp_err_t gpio_set_level(gpio_num_t Pin, uint32_t Level);
+int gpio_get_level(gpio_num_t Pin);
+
+#endif
@@ -0,0 +1,89 @@
+/* Host stub of ESP-IDF driver/spi_master.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_DRIVER_SPI_MASTER_H_
+#define _STUB_DRIVER_SPI_MASTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef int spi_host_device_t;
+#define SPI2_HOST 1
+#define HSPI_HOST SPI2_HOST
+
+#define SPI_DMA_CH_AUTO      3
+#define SPI_TRANS_USE_RXDATA (1 << 2)
+#define SPI_TRANS_USE_TXDATA (1 << 3)
+
+typedef struct
+{
+  int mosi_io_num;
+  int miso_io_num;
+  int sclk_io_num;
+  int quadwp_io_num;
+  int quadhd_io_num;
+  int max_transfer_sz;
+  uint32_t flags;
+  int intr_flags;
+} spi_bus_config_t;
+
+typedef struct spi_transaction_t spi_transaction_t;
+typedef void (*transaction_cb_t)(spi_transaction_t *Trans);
+
+typedef struct
+{
+  uint8_t command_bits;
+  uint8_t address_bits;
+  uint8_t dummy_bits;
+  uint8_t mode;
+  uint16_t duty_cycle_pos;
+  uint16_t cs_ena_pretrans;
+  uint8_t cs_ena_posttrans;
+  int clock_speed_hz;
+  int input_delay_ns;
+  int spics_io_num;
+  uint32_t flags;
+  int queue_size;
+  transaction_cb_t pre_cb;
+  transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+struct spi_transaction_t
+{
+  uint32_t flags;
+  uint16_t cmd;
+  uint64_t addr;
+  size_t length;
+  size_t rxlength;
+  void *user;
+  union
+  {
+    const void *tx_buffer;
+    uint8_t tx_data[4];
+  };
+  union
+  {
+    void *rx_buffer;
+    uint8_t rx_data[4];
+  };
+};
+
+typedef struct spi_device_t *spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t Host, const spi_bus_config_t *Config,
+                             int DmaChan);
+esp_err_t spi_bus_free(spi_host_device_t Host);
+esp_err_t spi_bus_add_device(spi_host_device_t Host,
+                             const spi_device_interface_config_t *Config,
+                             spi_device_handle_t *Handle);
+esp_err_t spi_bus_remove_device(spi_device_handle_t Handle);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t Handle,
+                                      spi_transaction_t *Trans);
+esp_err_t spi_device_queue_trans(spi_device_handle_t Handle,
+                                 spi_transaction_t *Trans, TickType_t Wait);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t Handle,
+                                      spi_transaction_t **Trans, TickType_t Wait);
+esp_err_t spi_device_acquire_bus(spi_device_handle_t Handle, TickType_t Wait);
+void spi_device_release_bus(spi_device_handle_t Handle);
+
+#endif
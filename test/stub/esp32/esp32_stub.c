@@ -0,0 +1,445 @@
+/* Host stubs of the ESP-IDF functions used by port/ESP32-IDF, driving the
+ * inline chain model of test/chain_stub.h */
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
+#include "rom/ets_sys.h"
+#include "74165_platform.h"
+#include "chain_stub.h"
+#include "esp32_stub.h"
+
+#define STUB_CPU_MHZ    240
+#define STUB_QUEUE_MAX  16
+
+struct StubSemaphore_s
+{
+  int Count;
+};
+
+struct spi_device_t
+{
+  int Dummy;
+};
+
+gpio_dev_t GPIO;
+
+static struct spi_device_t Device;
+
+static struct
+{
+  Esp32Stub_Stats_t Stats;
+  uint32_t Cycles;
+  uint32_t ClkRise;
+  uint32_t ClkFall;
+  uint8_t ClkFallSeen;
+  uint32_t Out;
+  uint8_t BusBusy;
+  uint8_t DeviceAdded;
+  int QueueSize;
+  spi_transaction_t *Queue[STUB_QUEUE_MAX];
+  uint32_t QueueHead;
+} Stub;
+
+
+/* Pins ------------------------------------------------------------------------*/
+
+static void
+Stub_ClkWrite(uint8_t Level)
+{
+  Level = Level ? 1 : 0;
+  if (Level && !ChainStub.Clk)
+  {
+    uint32_t Low = Stub.Cycles - Stub.ClkFall;
+    if (Stub.ClkFallSeen && Low < Stub.Stats.MinClkLowCycles)
+      Stub.Stats.MinClkLowCycles = Low;
+    Stub.ClkRise = Stub.Cycles;
+  }
+  else if (!Level && ChainStub.Clk)
+  {
+    uint32_t High = Stub.Cycles - Stub.ClkRise;
+    if (High < Stub.Stats.MinClkHighCycles)
+      Stub.Stats.MinClkHighCycles = High;
+    Stub.ClkFall = Stub.Cycles;
+    Stub.ClkFallSeen = 1;
+  }
+  ChainStub_ClkWrite(Level);
+}
+
+static void
+Stub_PinWrite(uint32_t Pin, uint8_t Level)
+{
+  Level = Level ? 1 : 0;
+  if (Pin == IC74165_CLK_GPIO)
+    Stub_ClkWrite(Level);
+  else if (Pin == IC74165_SHLD_GPIO)
+    ChainStub_ShLdWrite(Level);
+  else if (Pin == IC74165_CLKINH_GPIO)
+  {
+    ChainStub_ClkInhWrite(Level);
+    Stub.Stats.ClkInh = Level;
+  }
+}
+
+esp_err_t
+gpio_reset_pin(gpio_num_t Pin)
+{
+  (void)Pin;
+  return ESP_OK;
+}
+
+esp_err_t
+gpio_set_direction(gpio_num_t Pin, gpio_mode_t Mode)
+{
+  (void)Pin;
+  (void)Mode;
+  return ESP_OK;
+}
+
+esp_err_t
+gpio_set_level(gpio_num_t Pin, uint32_t Level)
+{
+  Stub_PinWrite(Pin, Level);
+  return ESP_OK;
+}
+
+int
+gpio_get_level(gpio_num_t Pin)
+{
+  return (Pin == IC74165_QH_GPIO) ? ChainStub_QhRead() : 0;
+}
+
+void
+Esp32Stub_GpioRegWrite(gpio_dev_t *Hw)
+{
+  uint32_t Old = Stub.Out;
+
+  Stub.Out = (Stub.Out | Hw->out_w1ts) & ~Hw->out_w1tc;
+  Hw->out = Stub.Out;
+  Hw->out_w1ts = 0;
+  Hw->out_w1tc = 0;
+
+  if ((Old ^ Stub.Out) & (1UL << IC74165_CLK_GPIO))
+    Stub_PinWrite(IC74165_CLK_GPIO, (Stub.Out >> IC74165_CLK_GPIO) & 1);
+  if ((Old ^ Stub.Out) & (1UL << IC74165_SHLD_GPIO))
+    Stub_PinWrite(IC74165_SHLD_GPIO, (Stub.Out >> IC74165_SHLD_GPIO) & 1);
+  if ((Old ^ Stub.Out) & (1UL << IC74165_CLKINH_GPIO))
+    Stub_PinWrite(IC74165_CLKINH_GPIO, (Stub.Out >> IC74165_CLKINH_GPIO) & 1);
+}
+
+void
+Esp32Stub_GpioRegRead(gpio_dev_t *Hw)
+{
+  Hw->in = (uint32_t)ChainStub_QhRead() << IC74165_QH_GPIO;
+}
+
+
+/* Time ------------------------------------------------------------------------*/
+
+uint32_t
+esp_cpu_get_cycle_count(void)
+{
+  return ++Stub.Cycles;
+}
+
+uint32_t
+esp_rom_get_cpu_ticks_per_us(void)
+{
+  return STUB_CPU_MHZ;
+}
+
+int64_t
+esp_timer_get_time(void)
+{
+  return Stub.Cycles / STUB_CPU_MHZ;
+}
+
+void
+ets_delay_us(uint32_t Us)
+{
+  Stub.Cycles += Us * STUB_CPU_MHZ;
+}
+
+
+/* Heap and semaphores ---------------------------------------------------------*/
+
+void *
+heap_caps_malloc(size_t Size, uint32_t Caps)
+{
+  void *Ptr;
+
+  (void)Caps;
+  Ptr = malloc(Size);
+  if (Ptr)
+    Stub.Stats.Allocs++;
+  return Ptr;
+}
+
+void
+heap_caps_free(void *Ptr)
+{
+  if (Ptr)
+    Stub.Stats.Allocs--;
+  free(Ptr);
+}
+
+SemaphoreHandle_t
+xSemaphoreCreateBinary(void)
+{
+  SemaphoreHandle_t Sem = heap_caps_malloc(sizeof(*Sem), 0);
+  if (Sem)
+    Sem->Count = 0;
+  return Sem;
+}
+
+BaseType_t
+xSemaphoreTake(SemaphoreHandle_t Sem, TickType_t Wait)
+{
+  if (Sem->Count > 0)
+  {
+    Sem->Count--;
+    return pdTRUE;
+  }
+  if (Wait == portMAX_DELAY)
+    Stub.Stats.Blocked++;
+  return pdFALSE;
+}
+
+BaseType_t
+xSemaphoreGive(SemaphoreHandle_t Sem)
+{
+  if (Sem->Count > 0)
+  {
+    Stub.Stats.Misuse++;
+    return pdFALSE;
+  }
+  Sem->Count++;
+  return pdTRUE;
+}
+
+void
+vSemaphoreDelete(SemaphoreHandle_t Sem)
+{
+  heap_caps_free(Sem);
+}
+
+
+/* SPI -------------------------------------------------------------------------*/
+
+/**
+ * @brief  SPI mode 1 with MOSI on SH/LD: MOSI changes on the rising edge of
+ *         SCK, just after the chain has seen it, and MISO is sampled on the
+ *         falling edge.
+ */
+static void
+Stub_Transfer(spi_transaction_t *Trans)
+{
+  const uint8_t *Tx = (Trans->flags & SPI_TRANS_USE_TXDATA) ?
+                      Trans->tx_data : (const uint8_t *)Trans->tx_buffer;
+  uint8_t *Rx = (Trans->flags & SPI_TRANS_USE_RXDATA) ?
+                Trans->rx_data : (uint8_t *)Trans->rx_buffer;
+
+  Stub.Stats.Transfers++;
+  for (size_t i = 0; i < Trans->length / 8; i++)
+  {
+    uint8_t Send = Tx ? Tx[i] : 0x00;
+    uint8_t Buffer = 0;
+
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      ChainStub_ClkWrite(1);
+      ChainStub_ShLdWrite((Send >> j) & 1);
+      Buffer |= ChainStub_QhRead() << j;
+      ChainStub_ClkWrite(0);
+    }
+
+    if (Rx)
+      Rx[i] = Buffer;
+  }
+}
+
+/**
+ * @brief  The bus is not available to this device while another one holds it.
+ */
+static esp_err_t
+Stub_BusWait(TickType_t Wait)
+{
+  if (!Stub.BusBusy)
+    return ESP_OK;
+  if (Wait == portMAX_DELAY)
+    Stub.Stats.Blocked++;
+  return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t
+spi_bus_initialize(spi_host_device_t Host, const spi_bus_config_t *Config,
+                   int DmaChan)
+{
+  (void)Host;
+  (void)Config;
+  (void)DmaChan;
+  return ESP_OK;
+}
+
+esp_err_t
+spi_bus_free(spi_host_device_t Host)
+{
+  (void)Host;
+  if (Stub.DeviceAdded)
+    Stub.Stats.Misuse++;
+  return ESP_OK;
+}
+
+esp_err_t
+spi_bus_add_device(spi_host_device_t Host,
+                   const spi_device_interface_config_t *Config,
+                   spi_device_handle_t *Handle)
+{
+  (void)Host;
+  if (Config->mode != 1 || Config->queue_size > STUB_QUEUE_MAX)
+    return ESP_ERR_INVALID_ARG;
+
+  Stub.QueueSize = Config->queue_size;
+  Stub.DeviceAdded = 1;
+  *Handle = &Device;
+  return ESP_OK;
+}
+
+esp_err_t
+spi_bus_remove_device(spi_device_handle_t Handle)
+{
+  if (Handle != &Device || Stub.Stats.InFlight || Stub.Stats.BusHeld)
+    Stub.Stats.Misuse++;
+  Stub.DeviceAdded = 0;
+  return ESP_OK;
+}
+
+esp_err_t
+spi_device_polling_transmit(spi_device_handle_t Handle, spi_transaction_t *Trans)
+{
+  if (Handle != &Device || Stub.Stats.InFlight)
+  {
+    Stub.Stats.Misuse++;
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!Stub.Stats.BusHeld && Stub_BusWait(portMAX_DELAY) != ESP_OK)
+    return ESP_ERR_TIMEOUT;
+
+  Stub_Transfer(Trans);
+  return ESP_OK;
+}
+
+esp_err_t
+spi_device_queue_trans(spi_device_handle_t Handle, spi_transaction_t *Trans,
+                       TickType_t Wait)
+{
+  if (Handle != &Device)
+    return ESP_ERR_INVALID_ARG;
+  if (Stub.Stats.InFlight >= (uint32_t)Stub.QueueSize)
+  {
+    if (Wait == portMAX_DELAY)
+      Stub.Stats.Blocked++;
+    return ESP_ERR_TIMEOUT;
+  }
+
+  Stub.Queue[(Stub.QueueHead + Stub.Stats.InFlight) % STUB_QUEUE_MAX] = Trans;
+  Stub.Stats.InFlight++;
+  return ESP_OK;
+}
+
+/**
+ * @brief  Queued transactions go on the wire when their result is taken, so
+ *         the inputs set by the test in between are seen by the next frame.
+ */
+esp_err_t
+spi_device_get_trans_result(spi_device_handle_t Handle, spi_transaction_t **Trans,
+                            TickType_t Wait)
+{
+  if (Handle != &Device)
+    return ESP_ERR_INVALID_ARG;
+  if (Stub.Stats.InFlight == 0)
+  {
+    if (Wait == portMAX_DELAY)
+      Stub.Stats.Blocked++;
+    return ESP_ERR_TIMEOUT;
+  }
+  if (!Stub.Stats.BusHeld && Stub_BusWait(Wait) != ESP_OK)
+    return ESP_ERR_TIMEOUT;
+
+  *Trans = Stub.Queue[Stub.QueueHead];
+  Stub.QueueHead = (Stub.QueueHead + 1) % STUB_QUEUE_MAX;
+  Stub.Stats.InFlight--;
+  Stub_Transfer(*Trans);
+  return ESP_OK;
+}
+
+esp_err_t
+spi_device_acquire_bus(spi_device_handle_t Handle, TickType_t Wait)
+{
+  if (Handle != &Device || Wait != portMAX_DELAY)
+    return ESP_ERR_INVALID_ARG;
+  if (Stub.Stats.BusHeld)
+  {
+    Stub.Stats.Misuse++;
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (Stub_BusWait(Wait) != ESP_OK)
+    return ESP_ERR_TIMEOUT;
+
+  Stub.Stats.BusHeld = 1;
+  return ESP_OK;
+}
+
+void
+spi_device_release_bus(spi_device_handle_t Handle)
+{
+  if (Handle != &Device || !Stub.Stats.BusHeld)
+    Stub.Stats.Misuse++;
+  Stub.Stats.BusHeld = 0;
+}
+
+
+/* Test interface --------------------------------------------------------------*/
+
+void
+Esp32Stub_Reset(void)
+{
+  memset(&Stub, 0, sizeof(Stub));
+  memset(&ChainStub, 0, sizeof(ChainStub));
+  memset(&GPIO, 0, sizeof(GPIO));
+  // CLK-INH starts high, so a scan that does not take it low reads no data
+  ChainStub.ShLd = 1;
+  ChainStub.ClkInh = 1;
+  Stub.Stats.ClkInh = 1;
+  Stub.Out = 1UL << IC74165_CLKINH_GPIO;
+  GPIO.out = Stub.Out;
+  Stub.Stats.MinClkHighCycles = UINT32_MAX;
+  Stub.Stats.MinClkLowCycles = UINT32_MAX;
+}
+
+void
+Esp32Stub_SetInputs(uint16_t Chip, uint8_t Value)
+{
+  if (Chip < CHAIN_STUB_MAX_CHIPS)
+    ChainStub.Inputs[Chip] = Value;
+}
+
+void
+Esp32Stub_SetBusBusy(uint8_t Busy)
+{
+  Stub.BusBusy = Busy;
+}
+
+void
+Esp32Stub_GetStats(Esp32Stub_Stats_t *Stats)
+{
+  *Stats = Stub.Stats;
+}
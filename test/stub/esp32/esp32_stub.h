@@ -0,0 +1,50 @@
+/* Chain model behind the ESP-IDF host stubs, for test/esp32_test.c */
+#ifndef _ESP32_STUB_H_
+#define _ESP32_STUB_H_
+
+#include <stdint.h>
+
+/**
+ * @brief  Counters of the stubs
+ */
+typedef struct Esp32Stub_Stats_s
+{
+  // Waits that would block forever on the target (portMAX_DELAY on a taken
+  // semaphore, or on a bus held by another device)
+  uint32_t Blocked;
+  // Calls made in a wrong state (e.g. polling while transfers are queued)
+  uint32_t Misuse;
+  // Outstanding heap_caps_malloc blocks and semaphores
+  int32_t Allocs;
+  // Transactions run on the modelled bus
+  uint32_t Transfers;
+  // Queued transactions not taken back with spi_device_get_trans_result
+  uint32_t InFlight;
+  // This device holds the bus (spi_device_acquire_bus)
+  uint8_t BusHeld;
+  // Level of CLK-INH
+  uint8_t ClkInh;
+  // Shortest CLK high and low phases driven through the GPIO registers, in
+  // esp_cpu_get_cycle_count cycles (UINT32_MAX if none)
+  uint32_t MinClkHighCycles;
+  uint32_t MinClkLowCycles;
+} Esp32Stub_Stats_t;
+
+/**
+ * @brief  Reset the stubs and the chain model. All inputs are 0.
+ */
+void Esp32Stub_Reset(void);
+
+/**
+ * @brief  Set parallel inputs of a chip. Chip 0 drives Qh.
+ */
+void Esp32Stub_SetInputs(uint16_t Chip, uint8_t Value);
+
+/**
+ * @brief  Mark the bus as held by another device on the same host.
+ */
+void Esp32Stub_SetBusBusy(uint8_t Busy);
+
+void Esp32Stub_GetStats(Esp32Stub_Stats_t *Stats);
+
+#endif
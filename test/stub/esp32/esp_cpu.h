@@ -0,0 +1,12 @@
+/* Host stub of ESP-IDF esp_cpu.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_ESP_CPU_H_
+#define _STUB_ESP_CPU_H_
+
+#include <stdint.h>
+
+/**
+ * @note   Every call advances the modelled cycle counter.
+ */
+uint32_t esp_cpu_get_cycle_count(void);
+
+#endif
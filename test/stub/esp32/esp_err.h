@@ -0,0 +1,14 @@
+/* Host stub of ESP-IDF esp_err.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_ESP_ERR_H_
+#define _STUB_ESP_ERR_H_
+
+typedef int esp_err_t;
+
+#define ESP_OK                 0
+#define ESP_FAIL              -1
+#define ESP_ERR_NO_MEM         0x101
+#define ESP_ERR_INVALID_ARG    0x102
+#define ESP_ERR_INVALID_STATE  0x103
+#define ESP_ERR_TIMEOUT        0x107
+
+#endif
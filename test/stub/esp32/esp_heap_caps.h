@@ -0,0 +1,13 @@
+/* Host stub of ESP-IDF esp_heap_caps.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_ESP_HEAP_CAPS_H_
+#define _STUB_ESP_HEAP_CAPS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_DMA (1 << 3)
+
+void *heap_caps_malloc(size_t Size, uint32_t Caps);
+void heap_caps_free(void *Ptr);
+
+#endif
@@ -0,0 +1,9 @@
+/* Host stub of ESP-IDF esp_rom_sys.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_ESP_ROM_SYS_H_
+#define _STUB_ESP_ROM_SYS_H_
+
+#include <stdint.h>
+
+uint32_t esp_rom_get_cpu_ticks_per_us(void);
+
+#endif
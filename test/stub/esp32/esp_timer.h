@@ -0,0 +1,9 @@
+/* Host stub of ESP-IDF esp_timer.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_ESP_TIMER_H_
+#define _STUB_ESP_TIMER_H_
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif
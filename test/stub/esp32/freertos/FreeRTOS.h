@@ -0,0 +1,16 @@
+/* Host stub of FreeRTOS.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_FREERTOS_H_
+#define _STUB_FREERTOS_H_
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE             1
+#define pdFALSE            0
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(MS)  ((TickType_t)(MS))
+
+#endif
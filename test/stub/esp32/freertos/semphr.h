@@ -0,0 +1,18 @@
+/* Host stub of FreeRTOS semphr.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_SEMPHR_H_
+#define _STUB_SEMPHR_H_
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct StubSemaphore_s *SemaphoreHandle_t;
+
+/**
+ * @note   The host is single threaded: a take that would block fails and is
+ *         counted by Esp32Stub_GetStats, instead of hanging the test.
+ */
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t Sem, TickType_t Wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t Sem);
+void vSemaphoreDelete(SemaphoreHandle_t Sem);
+
+#endif
@@ -0,0 +1,36 @@
+/* Host stub of ESP-IDF hal/gpio_ll.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_HAL_GPIO_LL_H_
+#define _STUB_HAL_GPIO_LL_H_
+
+#include <stdint.h>
+#include "soc/gpio_struct.h"
+
+/**
+ * @brief  Called after every register write, so the chain model sees the new
+ *         pin levels.
+ */
+void Esp32Stub_GpioRegWrite(gpio_dev_t *Hw);
+
+/**
+ * @brief  Called before every register read, so the IN register holds Qh.
+ */
+void Esp32Stub_GpioRegRead(gpio_dev_t *Hw);
+
+static inline void
+gpio_ll_set_level(gpio_dev_t *hw, uint32_t gpio_num, uint32_t level)
+{
+  if (level)
+    hw->out_w1ts = 1UL << gpio_num;
+  else
+    hw->out_w1tc = 1UL << gpio_num;
+  Esp32Stub_GpioRegWrite(hw);
+}
+
+static inline int
+gpio_ll_get_level(gpio_dev_t *hw, uint32_t gpio_num)
+{
+  Esp32Stub_GpioRegRead(hw);
+  return (hw->in >> gpio_num) & 0x1;
+}
+
+#endif
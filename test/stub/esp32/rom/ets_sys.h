@@ -0,0 +1,9 @@
+/* Host stub of ESP-IDF rom/ets_sys.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_ROM_ETS_SYS_H_
+#define _STUB_ROM_ETS_SYS_H_
+
+#include <stdint.h>
+
+void ets_delay_us(uint32_t Us);
+
+#endif
@@ -0,0 +1,17 @@
+/* Host stub of ESP-IDF soc/gpio_struct.h, only what port/ESP32-IDF uses */
+#ifndef _STUB_SOC_GPIO_STRUCT_H_
+#define _STUB_SOC_GPIO_STRUCT_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+  volatile uint32_t out;
+  volatile uint32_t out_w1ts;
+  volatile uint32_t out_w1tc;
+  volatile uint32_t in;
+} gpio_dev_t;
+
+extern gpio_dev_t GPIO;
+
+#endif
@@ -0,0 +1,433 @@
+/* Host stubs of libgpiod v2 and spidev used by port/Linux, driving the inline
+ * chain model of test/chain_stub.h. open, close and ioctl of the spidev device
+ * are taken over with the --wrap option of the linker. */
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include <gpiod.h>
+#include "74165_platform.h"
+#include "chain_stub.h"
+#include "linux_stub.h"
+
+#ifndef SPI_MOSI_IDLE_HIGH
+#define SPI_MOSI_IDLE_HIGH  (1U << 17)
+#endif
+
+#define STUB_LINES   64
+#define STUB_SPI_FD  1000
+
+struct gpiod_chip
+{
+  int Dummy;
+};
+
+struct gpiod_line_settings
+{
+  enum gpiod_line_direction Direction;
+  enum gpiod_line_value Value;
+};
+
+struct gpiod_line_config
+{
+  uint8_t Used[STUB_LINES];
+  struct gpiod_line_settings Settings[STUB_LINES];
+};
+
+struct gpiod_request_config
+{
+  int Dummy;
+};
+
+struct gpiod_line_request
+{
+  struct gpiod_line_config Config;
+};
+
+static struct
+{
+  LinuxStub_Stats_t Stats;
+  uint8_t MosiIdleHigh;
+  uint8_t SpiOpen;
+  uint32_t Mode;
+} Stub;
+
+int __real_open(const char *Path, int Flags, ...);
+int __real_close(int Fd);
+int __real_ioctl(int Fd, unsigned long Request, ...);
+
+
+/* libgpiod --------------------------------------------------------------------*/
+
+static void
+Stub_SetLine(unsigned int Line, enum gpiod_line_value Value)
+{
+  uint8_t Level = (Value == GPIOD_LINE_VALUE_ACTIVE) ? 1 : 0;
+
+  if (Line == IC74165_CLK_LINE)
+    ChainStub_ClkWrite(Level);
+  else if (Line == IC74165_SHLD_LINE)
+    ChainStub_ShLdWrite(Level);
+#if (IC74165_CLKINH_ENABLE)
+  else if (Line == IC74165_CLKINH_LINE)
+  {
+    ChainStub_ClkInhWrite(Level);
+    Stub.Stats.ClkInh = Level;
+  }
+#endif
+}
+
+static enum gpiod_line_value
+Stub_GetLine(unsigned int Line)
+{
+  if (Line == IC74165_QH_LINE && ChainStub_QhRead())
+    return GPIOD_LINE_VALUE_ACTIVE;
+  return GPIOD_LINE_VALUE_INACTIVE;
+}
+
+struct gpiod_chip *
+gpiod_chip_open(const char *path)
+{
+  (void)path;
+  return calloc(1, sizeof(struct gpiod_chip));
+}
+
+void
+gpiod_chip_close(struct gpiod_chip *chip)
+{
+  free(chip);
+}
+
+struct gpiod_line_settings *
+gpiod_line_settings_new(void)
+{
+  return calloc(1, sizeof(struct gpiod_line_settings));
+}
+
+void
+gpiod_line_settings_free(struct gpiod_line_settings *settings)
+{
+  free(settings);
+}
+
+void
+gpiod_line_settings_reset(struct gpiod_line_settings *settings)
+{
+  memset(settings, 0, sizeof(*settings));
+}
+
+int
+gpiod_line_settings_set_direction(struct gpiod_line_settings *settings,
+                                  enum gpiod_line_direction direction)
+{
+  settings->Direction = direction;
+  return 0;
+}
+
+int
+gpiod_line_settings_set_output_value(struct gpiod_line_settings *settings,
+                                     enum gpiod_line_value value)
+{
+  settings->Value = value;
+  return 0;
+}
+
+struct gpiod_line_config *
+gpiod_line_config_new(void)
+{
+  return calloc(1, sizeof(struct gpiod_line_config));
+}
+
+void
+gpiod_line_config_free(struct gpiod_line_config *config)
+{
+  free(config);
+}
+
+int
+gpiod_line_config_add_line_settings(struct gpiod_line_config *config,
+                                    const unsigned int *offsets,
+                                    size_t num_offsets,
+                                    struct gpiod_line_settings *settings)
+{
+  for (size_t i = 0; i < num_offsets; i++)
+  {
+    if (offsets[i] >= STUB_LINES)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+    config->Used[offsets[i]] = 1;
+    config->Settings[offsets[i]] = *settings;
+  }
+  return 0;
+}
+
+struct gpiod_request_config *
+gpiod_request_config_new(void)
+{
+  return calloc(1, sizeof(struct gpiod_request_config));
+}
+
+void
+gpiod_request_config_free(struct gpiod_request_config *config)
+{
+  free(config);
+}
+
+void
+gpiod_request_config_set_consumer(struct gpiod_request_config *config,
+                                  const char *consumer)
+{
+  (void)config;
+  (void)consumer;
+}
+
+struct gpiod_line_request *
+gpiod_chip_request_lines(struct gpiod_chip *chip,
+                         struct gpiod_request_config *req_cfg,
+                         struct gpiod_line_config *line_cfg)
+{
+  struct gpiod_line_request *Request;
+
+  (void)chip;
+  (void)req_cfg;
+  Request = malloc(sizeof(*Request));
+  if (Request == NULL)
+    return NULL;
+  Request->Config = *line_cfg;
+
+  // Outputs start at their configured values
+  for (unsigned int i = 0; i < STUB_LINES; i++)
+    if (line_cfg->Used[i] &&
+        line_cfg->Settings[i].Direction == GPIOD_LINE_DIRECTION_OUTPUT)
+      Stub_SetLine(i, line_cfg->Settings[i].Value);
+
+  return Request;
+}
+
+void
+gpiod_line_request_release(struct gpiod_line_request *request)
+{
+  free(request);
+}
+
+int
+gpiod_line_request_get_values_subset(struct gpiod_line_request *request,
+                                     size_t num_values,
+                                     const unsigned int *offsets,
+                                     enum gpiod_line_value *values)
+{
+  Stub.Stats.Ioctls++;
+  for (size_t i = 0; i < num_values; i++)
+  {
+    if (offsets[i] >= STUB_LINES || !request->Config.Used[offsets[i]])
+    {
+      errno = EINVAL;
+      return -1;
+    }
+    values[i] = Stub_GetLine(offsets[i]);
+  }
+  return 0;
+}
+
+enum gpiod_line_value
+gpiod_line_request_get_value(struct gpiod_line_request *request,
+                             unsigned int offset)
+{
+  enum gpiod_line_value Value;
+
+  if (gpiod_line_request_get_values_subset(request, 1, &offset, &Value) < 0)
+    return GPIOD_LINE_VALUE_ERROR;
+  return Value;
+}
+
+int
+gpiod_line_request_set_values_subset(struct gpiod_line_request *request,
+                                     size_t num_values,
+                                     const unsigned int *offsets,
+                                     const enum gpiod_line_value *values)
+{
+  Stub.Stats.Ioctls++;
+  for (size_t i = 0; i < num_values; i++)
+  {
+    if (offsets[i] >= STUB_LINES || !request->Config.Used[offsets[i]] ||
+        request->Config.Settings[offsets[i]].Direction != GPIOD_LINE_DIRECTION_OUTPUT)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  }
+  for (size_t i = 0; i < num_values; i++)
+    Stub_SetLine(offsets[i], values[i]);
+  return 0;
+}
+
+int
+gpiod_line_request_set_value(struct gpiod_line_request *request,
+                             unsigned int offset,
+                             enum gpiod_line_value value)
+{
+  return gpiod_line_request_set_values_subset(request, 1, &offset, &value);
+}
+
+
+/* spidev ----------------------------------------------------------------------*/
+
+/**
+ * @brief  SPI mode 1 with MOSI on SH/LD, like port/Host-Sim.
+ */
+static void
+Stub_Transfer(const struct spi_ioc_transfer *Xfer)
+{
+  const uint8_t *Tx = (const uint8_t *)(uintptr_t)Xfer->tx_buf;
+  uint8_t *Rx = (uint8_t *)(uintptr_t)Xfer->rx_buf;
+
+  for (uint32_t i = 0; i < Xfer->len; i++)
+  {
+    uint8_t Send = Tx ? Tx[i] : 0;
+    uint8_t Buffer = 0;
+
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      ChainStub_ClkWrite(1);
+      ChainStub_ShLdWrite((Send >> j) & 1);
+      Buffer |= ChainStub_QhRead() << j;
+      ChainStub_ClkWrite(0);
+    }
+    if (Rx)
+      Rx[i] = Buffer;
+  }
+  Stub.Stats.Transfers++;
+}
+
+static int
+Stub_Message(const struct spi_ioc_transfer *Xfer, unsigned int Count)
+{
+  for (unsigned int i = 0; i < Count; i++)
+    Stub_Transfer(&Xfer[i]);
+  Stub.Stats.Messages++;
+
+  // MOSI between messages
+  if (!(Stub.Mode & SPI_MOSI_IDLE_HIGH))
+  {
+    if (ChainStub.ShLd)
+      Stub.Stats.IdleLoads++;
+    ChainStub_ShLdWrite(0);
+  }
+  else
+  {
+    ChainStub_ShLdWrite(1);
+  }
+  return 0;
+}
+
+int
+__wrap_open(const char *Path, int Flags, ...)
+{
+  va_list Args;
+  int Mode;
+
+  if (strcmp(Path, IC74165_SPI_DEVICE) == 0)
+  {
+    Stub.SpiOpen = 1;
+    Stub.Mode = 0;
+    return STUB_SPI_FD;
+  }
+
+  va_start(Args, Flags);
+  Mode = va_arg(Args, int);
+  va_end(Args);
+  return __real_open(Path, Flags, Mode);
+}
+
+int
+__wrap_close(int Fd)
+{
+  if (Fd == STUB_SPI_FD)
+  {
+    Stub.SpiOpen = 0;
+    return 0;
+  }
+  return __real_close(Fd);
+}
+
+int
+__wrap_ioctl(int Fd, unsigned long Request, ...)
+{
+  va_list Args;
+  void *Arg;
+
+  va_start(Args, Request);
+  Arg = va_arg(Args, void *);
+  va_end(Args);
+
+  if (Fd != STUB_SPI_FD)
+    return __real_ioctl(Fd, Request, Arg);
+  if (!Stub.SpiOpen)
+  {
+    errno = EBADF;
+    return -1;
+  }
+
+  if (_IOC_TYPE(Request) == SPI_IOC_MAGIC && _IOC_NR(Request) == 0 &&
+      _IOC_DIR(Request) == _IOC_WRITE)
+    return Stub_Message(Arg, _IOC_SIZE(Request) / sizeof(struct spi_ioc_transfer));
+
+  switch (Request)
+  {
+  case SPI_IOC_WR_MODE32:
+    // Like spi_setup, mode bits the controller does not support are refused
+    if ((*(uint32_t *)Arg & SPI_MOSI_IDLE_HIGH) && !Stub.MosiIdleHigh)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+    Stub.Mode = *(uint32_t *)Arg;
+    return 0;
+  case SPI_IOC_RD_MODE32:
+    *(uint32_t *)Arg = Stub.Mode;
+    return 0;
+  case SPI_IOC_WR_MODE:
+    Stub.Mode = *(uint8_t *)Arg;
+    return 0;
+  case SPI_IOC_WR_BITS_PER_WORD:
+  case SPI_IOC_WR_MAX_SPEED_HZ:
+    return 0;
+  default:
+    errno = ENOTTY;
+    return -1;
+  }
+}
+
+
+/* Test interface --------------------------------------------------------------*/
+
+void
+LinuxStub_Reset(uint8_t MosiIdleHigh)
+{
+  memset(&Stub, 0, sizeof(Stub));
+  memset(&ChainStub, 0, sizeof(ChainStub));
+
+  // CLK-INH starts high, so a scan that does not take it low reads no data.
+  // Without IC74165_CLKINH_ENABLE it is tied low.
+  ChainStub.ShLd = 1;
+  ChainStub.ClkInh = IC74165_CLKINH_ENABLE;
+  Stub.Stats.ClkInh = IC74165_CLKINH_ENABLE;
+  Stub.MosiIdleHigh = MosiIdleHigh;
+}
+
+void
+LinuxStub_SetInputs(uint16_t Chip, uint8_t Value)
+{
+  if (Chip < CHAIN_STUB_MAX_CHIPS)
+    ChainStub.Inputs[Chip] = Value;
+}
+
+void
+LinuxStub_GetStats(LinuxStub_Stats_t *Stats)
+{
+  *Stats = Stub.Stats;
+}
@@ -0,0 +1,39 @@
+/* Chain model behind the libgpiod and spidev host stubs, for
+ * test/linux_test.c */
+#ifndef _LINUX_STUB_H_
+#define _LINUX_STUB_H_
+
+#include <stdint.h>
+
+/**
+ * @brief  Counters of the stubs
+ */
+typedef struct LinuxStub_Stats_s
+{
+  // GPIO get and set ioctls
+  uint32_t Ioctls;
+  // spidev messages and the transfers in them
+  uint32_t Messages;
+  uint32_t Transfers;
+  // Times SH/LD went low between two messages (a reload in the middle of a
+  // scan if CLK-INH is low)
+  uint32_t IdleLoads;
+  // Level of CLK-INH
+  uint8_t ClkInh;
+} LinuxStub_Stats_t;
+
+/**
+ * @brief  Reset the stubs and the chain model. All inputs are 0.
+ * @param  MosiIdleHigh: 1 if the SPI controller supports SPI_MOSI_IDLE_HIGH.
+ *         Without it, MOSI goes low between messages.
+ */
+void LinuxStub_Reset(uint8_t MosiIdleHigh);
+
+/**
+ * @brief  Set parallel inputs of a chip. Chip 0 drives Qh.
+ */
+void LinuxStub_SetInputs(uint16_t Chip, uint8_t Value);
+
+void LinuxStub_GetStats(LinuxStub_Stats_t *Stats);
+
+#endif
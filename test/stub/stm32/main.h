@@ -0,0 +1,90 @@
+/* Host stub of an STM32Cube main.h (HAL and CMSIS), only what
+ * port/STM32-HAL uses. Register accesses go through functions, so the chain
+ * model of stm32_stub.c sees each BSRR write and a cycle counter advances. */
+#ifndef _STUB_MAIN_H_
+#define _STUB_MAIN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __CORTEX_M
+#define __CORTEX_M 4U
+#endif
+
+#define HAL_SPI_MODULE_ENABLED
+
+/* HAL -------------------------------------------------------------------------*/
+typedef enum
+{
+  HAL_OK = 0x00U,
+  HAL_ERROR = 0x01U,
+  HAL_BUSY = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+  volatile uint32_t IDR;
+  volatile uint32_t ODR;
+  volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_PIN_0                 ((uint16_t)0x0001)
+#define GPIO_PIN_1                 ((uint16_t)0x0002)
+#define GPIO_PIN_2                 ((uint16_t)0x0004)
+#define GPIO_PIN_3                 ((uint16_t)0x0008)
+#define GPIO_MODE_INPUT            0x00000000U
+#define GPIO_MODE_OUTPUT_PP        0x00000001U
+#define GPIO_NOPULL                0x00000000U
+#define GPIO_SPEED_FREQ_VERY_HIGH  0x00000003U
+
+typedef struct
+{
+  int Instance;
+} SPI_HandleTypeDef;
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi,
+                                              uint8_t *pTxData, uint8_t *pRxData,
+                                              uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+/* CMSIS -----------------------------------------------------------------------*/
+typedef struct
+{
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL << 24)
+
+extern uint32_t SystemCoreClock;
+
+GPIO_TypeDef *Stm32Stub_GPIOA(void);
+DWT_Type *Stm32Stub_DWT(void);
+CoreDebug_Type *Stm32Stub_CoreDebug(void);
+void Stm32Stub_NOP(void);
+
+#define GPIOA      (Stm32Stub_GPIOA())
+#define DWT        (Stm32Stub_DWT())
+#define CoreDebug  (Stm32Stub_CoreDebug())
+#define __NOP()    Stm32Stub_NOP()
+
+#endif
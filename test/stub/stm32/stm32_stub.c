@@ -0,0 +1,259 @@
+/* Host stubs of the STM32 HAL and CMSIS parts used by port/STM32-HAL, driving
+ * the inline chain model of test/chain_stub.h */
+#include <string.h>
+#include "main.h"
+#include "74165_platform.h"
+#include "chain_stub.h"
+#include "stm32_stub.h"
+
+// Modelled cost of a peripheral register access and of a __NOP (cycles). The
+// NOP also carries the decrement and branch of the delay loop around it, as on
+// a Cortex-M0.
+#define STUB_GPIO_CYCLES 2
+#define STUB_NOP_CYCLES  3
+
+uint32_t SystemCoreClock = 168000000;
+
+static GPIO_TypeDef GpioA;
+static DWT_Type Dwt;
+static CoreDebug_Type Debug;
+
+static struct
+{
+  Stm32Stub_Stats_t Stats;
+  uint32_t Out;
+  uint32_t ClkRise;
+  uint32_t ClkFall;
+  uint8_t ClkFallSeen;
+  uint8_t Deferred;
+  uint8_t FailNext;
+  SPI_HandleTypeDef *Hspi;
+  uint8_t *Tx;
+  uint8_t *Rx;
+  uint16_t Len;
+} Stub;
+
+
+/* Pins and time ---------------------------------------------------------------*/
+
+static void
+Stub_ClkWrite(uint8_t Level)
+{
+  uint32_t Now = Stub.Stats.Cycles;
+
+  if (Level && !ChainStub.Clk)
+  {
+    if (Stub.ClkFallSeen && Now - Stub.ClkFall < Stub.Stats.MinClkLowCycles)
+      Stub.Stats.MinClkLowCycles = Now - Stub.ClkFall;
+    Stub.ClkRise = Now;
+  }
+  else if (!Level && ChainStub.Clk)
+  {
+    if (Now - Stub.ClkRise < Stub.Stats.MinClkHighCycles)
+      Stub.Stats.MinClkHighCycles = Now - Stub.ClkRise;
+    Stub.ClkFall = Now;
+    Stub.ClkFallSeen = 1;
+  }
+  ChainStub_ClkWrite(Level);
+}
+
+/**
+ * @brief  Apply the last BSRR write to the pins. It runs on every register
+ *         access, DWT read and __NOP, so a write takes effect before the time
+ *         goes on.
+ */
+static void
+Stub_Flush(void)
+{
+  uint32_t Old = Stub.Out;
+
+  if (GpioA.BSRR == 0)
+    return;
+  Stub.Out = (Stub.Out & ~(GpioA.BSRR >> 16)) | (GpioA.BSRR & 0xFFFF);
+  GpioA.BSRR = 0;
+  GpioA.ODR = Stub.Out;
+
+  if ((Old ^ Stub.Out) & IC74165_CLK_PIN)
+    Stub_ClkWrite((Stub.Out & IC74165_CLK_PIN) ? 1 : 0);
+  if ((Old ^ Stub.Out) & IC74165_SHLD_PIN)
+    ChainStub_ShLdWrite((Stub.Out & IC74165_SHLD_PIN) ? 1 : 0);
+  if ((Old ^ Stub.Out) & IC74165_CLKINH_PIN)
+  {
+    ChainStub_ClkInhWrite((Stub.Out & IC74165_CLKINH_PIN) ? 1 : 0);
+    Stub.Stats.ClkInh = (Stub.Out & IC74165_CLKINH_PIN) ? 1 : 0;
+  }
+}
+
+GPIO_TypeDef *
+Stm32Stub_GPIOA(void)
+{
+  Stub_Flush();
+  Stub.Stats.Cycles += STUB_GPIO_CYCLES;
+  GpioA.IDR = ChainStub_QhRead() ? IC74165_QH_PIN : 0;
+  return &GpioA;
+}
+
+DWT_Type *
+Stm32Stub_DWT(void)
+{
+  Stub_Flush();
+  Stub.Stats.Cycles++;
+  Dwt.CYCCNT = Stub.Stats.Cycles;
+  return &Dwt;
+}
+
+CoreDebug_Type *
+Stm32Stub_CoreDebug(void)
+{
+  return &Debug;
+}
+
+void
+Stm32Stub_NOP(void)
+{
+  Stub_Flush();
+  Stub.Stats.Cycles += STUB_NOP_CYCLES;
+}
+
+void
+HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+  (void)GPIOx;
+  (void)GPIO_Init;
+}
+
+
+/* SPI and DMA -----------------------------------------------------------------*/
+
+// Weak defaults, as in the HAL, for builds without the SPI mode
+__attribute__((weak)) void
+HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  (void)hspi;
+}
+
+__attribute__((weak)) void
+HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  (void)hspi;
+}
+
+/**
+ * @brief  SPI mode 1 with MOSI on SH/LD, like port/Host-Sim.
+ */
+static void
+Stub_Transfer(void)
+{
+  for (uint16_t i = 0; i < Stub.Len; i++)
+  {
+    uint8_t Send = Stub.Tx[i];
+    uint8_t Buffer = 0;
+
+    for (int8_t j = 7; j >= 0; j--)
+    {
+      ChainStub_ClkWrite(1);
+      ChainStub_ShLdWrite((Send >> j) & 1);
+      Buffer |= ChainStub_QhRead() << j;
+      ChainStub_ClkWrite(0);
+    }
+    Stub.Rx[i] = Buffer;
+  }
+}
+
+static void
+Stub_Complete(void)
+{
+  SPI_HandleTypeDef *Hspi = Stub.Hspi;
+
+  Stub.Stats.Running = 0;
+  if (Stub.FailNext)
+  {
+    Stub.FailNext = 0;
+    Stub.Stats.Errors++;
+    HAL_SPI_ErrorCallback(Hspi);
+    return;
+  }
+
+  Stub_Transfer();
+  HAL_SPI_TxRxCpltCallback(Hspi);
+}
+
+HAL_StatusTypeDef
+HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                            uint8_t *pRxData, uint16_t Size)
+{
+  if (Stub.Stats.Running)
+    return HAL_BUSY;
+  if (pTxData == NULL || pRxData == NULL || Size == 0)
+    return HAL_ERROR;
+
+  Stub_Flush();
+  Stub.Hspi = hspi;
+  Stub.Tx = pTxData;
+  Stub.Rx = pRxData;
+  Stub.Len = Size;
+  Stub.Stats.Running = 1;
+  Stub.Stats.Transfers++;
+
+  if (!Stub.Deferred)
+    Stub_Complete();
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef
+HAL_SPI_Abort(SPI_HandleTypeDef *hspi)
+{
+  (void)hspi;
+  Stub.Stats.Running = 0;
+  return HAL_OK;
+}
+
+
+/* Test interface --------------------------------------------------------------*/
+
+void
+Stm32Stub_Reset(uint8_t Deferred)
+{
+  memset(&Stub, 0, sizeof(Stub));
+  memset(&ChainStub, 0, sizeof(ChainStub));
+  memset(&GpioA, 0, sizeof(GpioA));
+  memset(&Dwt, 0, sizeof(Dwt));
+
+  // CLK-INH starts high, so a scan that does not take it low reads no data.
+  // Without IC74165_CLKINH_ENABLE it is tied low.
+  ChainStub.ShLd = 1;
+  ChainStub.ClkInh = IC74165_CLKINH_ENABLE;
+  Stub.Stats.ClkInh = IC74165_CLKINH_ENABLE;
+  Stub.Out = IC74165_CLKINH_ENABLE ? IC74165_CLKINH_PIN : 0;
+  GpioA.ODR = Stub.Out;
+  Stub.Deferred = Deferred;
+  Stub.Stats.MinClkHighCycles = UINT32_MAX;
+  Stub.Stats.MinClkLowCycles = UINT32_MAX;
+}
+
+void
+Stm32Stub_SetInputs(uint16_t Chip, uint8_t Value)
+{
+  if (Chip < CHAIN_STUB_MAX_CHIPS)
+    ChainStub.Inputs[Chip] = Value;
+}
+
+void
+Stm32Stub_FailNext(void)
+{
+  Stub.FailNext = 1;
+}
+
+void
+Stm32Stub_Irq(void)
+{
+  if (Stub.Stats.Running)
+    Stub_Complete();
+}
+
+void
+Stm32Stub_GetStats(Stm32Stub_Stats_t *Stats)
+{
+  Stub_Flush();
+  *Stats = Stub.Stats;
+}
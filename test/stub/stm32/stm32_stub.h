@@ -0,0 +1,51 @@
+/* Chain model behind the STM32 HAL host stubs, for test/stm32_test.c */
+#ifndef _STM32_STUB_H_
+#define _STM32_STUB_H_
+
+#include <stdint.h>
+
+/**
+ * @brief  Counters of the stubs
+ */
+typedef struct Stm32Stub_Stats_s
+{
+  // Modelled CPU cycles
+  uint32_t Cycles;
+  // DMA transfers started and failed
+  uint32_t Transfers;
+  uint32_t Errors;
+  // A DMA transfer is running
+  uint8_t Running;
+  // Level of CLK-INH
+  uint8_t ClkInh;
+  // Shortest CLK high and low phases (cycles, UINT32_MAX if none)
+  uint32_t MinClkHighCycles;
+  uint32_t MinClkLowCycles;
+} Stm32Stub_Stats_t;
+
+/**
+ * @brief  Reset the stubs and the chain model. All inputs are 0.
+ * @param  Deferred: 0 to complete DMA transfers before
+ *         HAL_SPI_TransmitReceive_DMA returns, 1 to complete them in
+ *         Stm32Stub_Irq
+ */
+void Stm32Stub_Reset(uint8_t Deferred);
+
+/**
+ * @brief  Set parallel inputs of a chip. Chip 0 drives Qh.
+ */
+void Stm32Stub_SetInputs(uint16_t Chip, uint8_t Value);
+
+/**
+ * @brief  Make the next DMA transfer end with HAL_SPI_ErrorCallback.
+ */
+void Stm32Stub_FailNext(void);
+
+/**
+ * @brief  Complete the running DMA transfer (deferred mode).
+ */
+void Stm32Stub_Irq(void);
+
+void Stm32Stub_GetStats(Stm32Stub_Stats_t *Stats);
+
+#endif
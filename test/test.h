@@ -0,0 +1,63 @@
+/**
+ **********************************************************************************
+ * @file   test.h
+ * @author Hossein.M (https://github.com/Hossein-M98)
+ * @brief  Minimal assertion helpers for host tests
+ **********************************************************************************
+ *
+ * Copyright (c) 2021 Hossein.M (MIT License)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **********************************************************************************
+ */
+
+/* Define to prevent recursive inclusion ----------------------------------------*/
+#ifndef _TEST_H_
+#define _TEST_H_
+
+/* Includes ---------------------------------------------------------------------*/
+#include <stdio.h>
+
+
+/* Exported Variables -----------------------------------------------------------*/
+static int TestFailures = 0;
+
+
+/* Exported Macros --------------------------------------------------------------*/
+/**
+ * @brief  Report a failed condition and keep running.
+ */
+#define TEST_CHECK(COND)                                              \
+  do                                                                  \
+  {                                                                   \
+    if (!(COND))                                                      \
+    {                                                                 \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #COND); \
+      TestFailures++;                                                 \
+    }                                                                 \
+  } while (0)
+
+/**
+ * @brief  Exit code of a test program.
+ */
+#define TEST_RESULT() (TestFailures ? 1 : 0)
+
+
+#endif //! _TEST_H_